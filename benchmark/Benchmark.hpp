@@ -0,0 +1,119 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BENCHMARK_HPP
+#define OPCOSERIALIZER_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace OpCoSerializer::Benchmark
+{
+    /// Prevents the compiler from optimizing away the computation of value.
+    /// @param value The value.
+    template <typename T>
+    inline void DoNotOptimize(T const& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /// Runs f the given number of times and prints the time per iteration.
+    /// @param name The benchmark name.
+    /// @param iterations The number of iterations.
+    /// @param bytes The number of bytes processed per iteration, used to report
+    /// throughput. Zero to omit the throughput.
+    /// @param f The function to benchmark.
+    /// @returns The time per iteration in nanoseconds.
+    template <typename F>
+    double Run(std::string_view name, std::size_t iterations, std::size_t bytes, F&& f)
+    {
+        // Warm up caches and any reusable buffers before measuring.
+        for (std::size_t i = 0; i < iterations / 10 + 1; ++i)
+        {
+            f();
+        }
+
+        // Report the fastest of several repetitions, which is the least
+        // affected by noise from the rest of the system.
+        auto constexpr repetitions = 5;
+        auto nanoseconds = std::numeric_limits<double>::max();
+        for (auto repetition = 0; repetition < repetitions; ++repetition)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < iterations / repetitions + 1; ++i)
+            {
+                f();
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            auto elapsed = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations / repetitions + 1);
+            nanoseconds = std::min(nanoseconds, elapsed);
+        }
+
+        if (bytes == 0)
+        {
+            std::printf("%-48.*s %12.1f ns/op\n", static_cast<int>(name.size()), name.data(), nanoseconds);
+        }
+        else
+        {
+            auto megabytesPerSecond = static_cast<double>(bytes) / nanoseconds * 1e3;
+            std::printf("%-48.*s %12.1f ns/op %10.1f MB/s\n", static_cast<int>(name.size()), name.data(), nanoseconds, megabytesPerSecond);
+        }
+
+        return nanoseconds;
+    }
+
+    /// A named group of benchmarks.
+    struct Suite final
+    {
+        /// The suite name.
+        std::string_view name;
+
+        /// Runs the benchmarks in the suite.
+        void (*run)();
+    };
+
+    /// Gets the registered benchmark suites.
+    /// @returns The suites.
+    inline std::vector<Suite>& Suites()
+    {
+        static std::vector<Suite> suites;
+        return suites;
+    }
+
+    /// Registers a benchmark suite on construction.
+    struct Registration final
+    {
+        /// Registers a benchmark suite.
+        /// @param name The suite name.
+        /// @param run The function that runs the suite.
+        Registration(std::string_view name, void (*run)())
+        {
+            Suites().push_back(Suite{ name, run });
+        }
+    };
+}
+
+#endif // OPCOSERIALIZER_BENCHMARK_HPP
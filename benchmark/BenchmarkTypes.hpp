@@ -0,0 +1,239 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BENCHMARK_TYPES_HPP
+#define OPCOSERIALIZER_BENCHMARK_TYPES_HPP
+
+#include <string>
+#include <vector>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+namespace OpCoSerializer::Benchmark
+{
+    enum class EntityKind
+    {
+        Vehicle,
+        Aircraft,
+        Vessel
+    };
+
+    struct Vector3 final
+    {
+        double x = 0.0;
+        double y = 0.0;
+        double z = 0.0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Vector3::x, "x"),
+                MakeProperty(&Vector3::y, "y"),
+                MakeProperty(&Vector3::z, "z")
+            );
+        };
+    };
+
+    struct Entity final
+    {
+        int id = 0;
+        std::string name;
+        EntityKind kind = EntityKind::Vehicle;
+        bool active = true;
+        Vector3 position;
+        Vector3 velocity;
+        double heading = 0.0;
+        double fuel = 0.0;
+        std::vector<double> sensorReadings;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Entity::id, "id"),
+                MakeProperty(&Entity::name, "name"),
+                MakeProperty(&Entity::kind, "kind"),
+                MakeProperty(&Entity::active, "active"),
+                MakeProperty(&Entity::position, "position"),
+                MakeProperty(&Entity::velocity, "velocity"),
+                MakeProperty(&Entity::heading, "heading"),
+                MakeProperty(&Entity::fuel, "fuel"),
+                MakeProperty(&Entity::sensorReadings, "sensorReadings")
+            );
+        };
+    };
+
+    struct WorldState final
+    {
+        int64_t tick = 0;
+        double time = 0.0;
+        std::vector<Entity> entities;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WorldState::tick, "tick"),
+                MakeProperty(&WorldState::time, "time"),
+                MakeProperty(&WorldState::entities, "entities")
+            );
+        };
+    };
+
+    // An entity with many properties, where finding each property dominates.
+    struct WideEntity final
+    {
+        double id = 0.5;
+        std::string name = "name-1";
+        std::string callsign = "callsign-2";
+        double side = 3.5;
+        double kind = 4.5;
+        double active = 5.5;
+        double damaged = 6.5;
+        double tracked = 7.5;
+        double latitude = 8.5;
+        double longitude = 9.5;
+        double altitude = 10.5;
+        double heading = 11.5;
+        double pitch = 12.5;
+        double roll = 13.5;
+        double speed = 14.5;
+        double climbRate = 15.5;
+        double turnRate = 16.5;
+        double fuel = 17.5;
+        double fuelFlow = 18.5;
+        double mass = 19.5;
+        double drag = 20.5;
+        double lift = 21.5;
+        double thrust = 22.5;
+        double throttle = 23.5;
+        double range = 24.5;
+        double bearing = 25.5;
+        double elevation = 26.5;
+        double signalStrength = 27.5;
+        double noise = 28.5;
+        double temperature = 29.5;
+        double pressure = 30.5;
+        double humidity = 31.5;
+        double windSpeed = 32.5;
+        double windDirection = 33.5;
+        double visibility = 34.5;
+        double cloudBase = 35.5;
+        double weaponCount = 36.5;
+        double ammunition = 37.5;
+        double reloadTime = 38.5;
+        double cooldown = 39.5;
+        double health = 40.5;
+        double armour = 41.5;
+        double shield = 42.5;
+        double morale = 43.5;
+        double fatigue = 44.5;
+        double experience = 45.5;
+        double rank = 46.5;
+        double unitSize = 47.5;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WideEntity::id, "id"),
+                MakeProperty(&WideEntity::name, "name"),
+                MakeProperty(&WideEntity::callsign, "callsign"),
+                MakeProperty(&WideEntity::side, "side"),
+                MakeProperty(&WideEntity::kind, "kind"),
+                MakeProperty(&WideEntity::active, "active"),
+                MakeProperty(&WideEntity::damaged, "damaged"),
+                MakeProperty(&WideEntity::tracked, "tracked"),
+                MakeProperty(&WideEntity::latitude, "latitude"),
+                MakeProperty(&WideEntity::longitude, "longitude"),
+                MakeProperty(&WideEntity::altitude, "altitude"),
+                MakeProperty(&WideEntity::heading, "heading"),
+                MakeProperty(&WideEntity::pitch, "pitch"),
+                MakeProperty(&WideEntity::roll, "roll"),
+                MakeProperty(&WideEntity::speed, "speed"),
+                MakeProperty(&WideEntity::climbRate, "climbRate"),
+                MakeProperty(&WideEntity::turnRate, "turnRate"),
+                MakeProperty(&WideEntity::fuel, "fuel"),
+                MakeProperty(&WideEntity::fuelFlow, "fuelFlow"),
+                MakeProperty(&WideEntity::mass, "mass"),
+                MakeProperty(&WideEntity::drag, "drag"),
+                MakeProperty(&WideEntity::lift, "lift"),
+                MakeProperty(&WideEntity::thrust, "thrust"),
+                MakeProperty(&WideEntity::throttle, "throttle"),
+                MakeProperty(&WideEntity::range, "range"),
+                MakeProperty(&WideEntity::bearing, "bearing"),
+                MakeProperty(&WideEntity::elevation, "elevation"),
+                MakeProperty(&WideEntity::signalStrength, "signalStrength"),
+                MakeProperty(&WideEntity::noise, "noise"),
+                MakeProperty(&WideEntity::temperature, "temperature"),
+                MakeProperty(&WideEntity::pressure, "pressure"),
+                MakeProperty(&WideEntity::humidity, "humidity"),
+                MakeProperty(&WideEntity::windSpeed, "windSpeed"),
+                MakeProperty(&WideEntity::windDirection, "windDirection"),
+                MakeProperty(&WideEntity::visibility, "visibility"),
+                MakeProperty(&WideEntity::cloudBase, "cloudBase"),
+                MakeProperty(&WideEntity::weaponCount, "weaponCount"),
+                MakeProperty(&WideEntity::ammunition, "ammunition"),
+                MakeProperty(&WideEntity::reloadTime, "reloadTime"),
+                MakeProperty(&WideEntity::cooldown, "cooldown"),
+                MakeProperty(&WideEntity::health, "health"),
+                MakeProperty(&WideEntity::armour, "armour"),
+                MakeProperty(&WideEntity::shield, "shield"),
+                MakeProperty(&WideEntity::morale, "morale"),
+                MakeProperty(&WideEntity::fatigue, "fatigue"),
+                MakeProperty(&WideEntity::experience, "experience"),
+                MakeProperty(&WideEntity::rank, "rank"),
+                MakeProperty(&WideEntity::unitSize, "unitSize")
+            );
+        };
+    };
+
+    /// Creates a deterministic entity.
+    /// @param id The entity id.
+    /// @returns The entity.
+    inline Entity MakeEntity(int id)
+    {
+        Entity entity;
+        entity.id = id;
+        entity.name = "entity-" + std::to_string(id);
+        entity.kind = static_cast<EntityKind>(id % 3);
+        entity.active = id % 2 == 0;
+        entity.position = Vector3{ id * 1.5, id * -0.25, 1000.0 + id };
+        entity.velocity = Vector3{ 12.75, -3.125, 0.5 * id };
+        entity.heading = 0.1 * id;
+        entity.fuel = 1.0 / (id + 1);
+        for (int i = 0; i < 8; ++i)
+        {
+            entity.sensorReadings.push_back(id + i / 7.0);
+        }
+
+        return entity;
+    }
+
+    /// Creates a deterministic world state.
+    /// @param entities The number of entities.
+    /// @returns The world state.
+    inline WorldState MakeWorldState(int entities)
+    {
+        WorldState state;
+        state.tick = 123456;
+        state.time = 4115.2;
+        for (int i = 0; i < entities; ++i)
+        {
+            state.entities.push_back(MakeEntity(i));
+        }
+
+        return state;
+    }
+}
+
+#endif // OPCOSERIALIZER_BENCHMARK_TYPES_HPP
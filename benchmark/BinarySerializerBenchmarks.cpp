@@ -0,0 +1,203 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Binary;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    // Compares the binary encoding with the JSON encoding of the same value,
+    // reporting the throughput of each relative to the size of the value's
+    // JSON, so the numbers are directly comparable.
+    void RunBinaryBenchmarks()
+    {
+        auto state = MakeWorldState(100);
+        JsonSerializer jsonSerializer{};
+        BinarySerializer binarySerializer;
+        auto json = jsonSerializer.Serialize(state);
+        auto binary = binarySerializer.Serialize(state);
+        std::printf("Size/Json %zu bytes, Size/Binary %zu bytes (%.1fx smaller)\n",
+            json.size(), binary.size(), static_cast<double>(json.size()) / static_cast<double>(binary.size()));
+
+        std::string serialized;
+        Run("Serialize/Json", 2000, json.size(), [&] {
+            jsonSerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/Binary", 20000, json.size(), [&] {
+            binarySerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+
+        WorldState target;
+        Run("Deserialize/Json", 2000, json.size(), [&] {
+            jsonSerializer.DeserializeInto(json, target);
+            DoNotOptimize(target);
+        });
+        Run("Deserialize/Binary", 20000, json.size(), [&] {
+            binarySerializer.DeserializeInto(binary, target);
+            DoNotOptimize(target);
+        });
+    }
+
+    // Vectors of numbers and of plain structs make up most of the bytes of
+    // typical payloads.
+    void RunBinaryVectorBenchmarks()
+    {
+        std::vector<double> doubles(100000);
+        std::vector<Vector3> vectors(30000);
+        for (std::size_t i = 0; i < doubles.size(); ++i)
+        {
+            doubles[i] = static_cast<double>(i) * 0.25;
+        }
+
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+        {
+            vectors[i] = Vector3 { static_cast<double>(i), 0.5, -1.0 };
+        }
+
+        BinarySerializer serializer;
+        std::string serialized;
+        auto serializedDoubles = serializer.Serialize(doubles);
+        auto serializedVectors = serializer.Serialize(vectors);
+
+        Run("Serialize/Binary/Doubles", 2000, serializedDoubles.size(), [&] {
+            serializer.Serialize(doubles, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Binary/Doubles", 2000, serializedDoubles.size(), [&] {
+            serializer.DeserializeInto(serializedDoubles, doubles);
+            DoNotOptimize(doubles);
+        });
+        Run("Serialize/Binary/Vector3s", 2000, serializedVectors.size(), [&] {
+            serializer.Serialize(vectors, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Binary/Vector3s", 2000, serializedVectors.size(), [&] {
+            serializer.DeserializeInto(serializedVectors, vectors);
+            DoNotOptimize(vectors);
+        });
+    }
+
+    // Entities written row by row compared with one column per property.
+    void RunColumnarBenchmarks()
+    {
+        auto rows = MakeWorldState(10000).entities;
+        Columnar<Entity> columns(rows);
+        JsonSerializer jsonSerializer{};
+        BinarySerializer binarySerializer;
+        auto jsonRows = jsonSerializer.Serialize(rows);
+        auto jsonColumns = jsonSerializer.Serialize(columns);
+        auto binaryRows = binarySerializer.Serialize(rows);
+        auto binaryColumns = binarySerializer.Serialize(columns);
+        std::printf("Size/Json/Rows %zu bytes, Size/Json/Columns %zu bytes, Size/Binary/Rows %zu bytes, Size/Binary/Columns %zu bytes\n",
+            jsonRows.size(), jsonColumns.size(), binaryRows.size(), binaryColumns.size());
+
+        std::string serialized;
+        Run("Serialize/Json/Rows", 20, jsonRows.size(), [&] {
+            jsonSerializer.Serialize(rows, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/Json/Columns", 20, jsonColumns.size(), [&] {
+            jsonSerializer.Serialize(columns, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Json/Rows", 20, jsonRows.size(), [&] {
+            jsonSerializer.DeserializeInto(jsonRows, rows);
+            DoNotOptimize(rows);
+        });
+        Run("Deserialize/Json/Columns", 20, jsonColumns.size(), [&] {
+            jsonSerializer.DeserializeInto(jsonColumns, columns);
+            DoNotOptimize(columns);
+        });
+        Run("Serialize/Binary/Rows", 200, binaryRows.size(), [&] {
+            binarySerializer.Serialize(rows, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/Binary/Columns", 200, binaryColumns.size(), [&] {
+            binarySerializer.Serialize(columns, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Binary/Rows", 200, binaryRows.size(), [&] {
+            binarySerializer.DeserializeInto(binaryRows, rows);
+            DoNotOptimize(rows);
+        });
+        Run("Deserialize/Binary/Columns", 200, binaryColumns.size(), [&] {
+            binarySerializer.DeserializeInto(binaryColumns, columns);
+            DoNotOptimize(columns);
+        });
+    }
+
+    // Consecutive ticks where only a few entities move, written in full
+    // compared with the delta from the previous tick.
+    void RunDeltaBenchmarks()
+    {
+        auto previous = MakeWorldState(1000);
+        auto current = previous;
+        current.tick += 1;
+        for (std::size_t i = 0; i < current.entities.size(); i += 20)
+        {
+            current.entities[i].position.x += 1.0;
+        }
+
+        JsonSerializer jsonSerializer{};
+        BinarySerializer binarySerializer;
+        auto json = jsonSerializer.Serialize(current);
+        auto jsonDelta = jsonSerializer.SerializeDelta(previous, current);
+        auto binary = binarySerializer.Serialize(current);
+        auto binaryDelta = binarySerializer.SerializeDelta(previous, current);
+        std::printf("Size/Json %zu bytes, Size/Json/Delta %zu bytes, Size/Binary %zu bytes, Size/Binary/Delta %zu bytes\n",
+            json.size(), jsonDelta.size(), binary.size(), binaryDelta.size());
+
+        std::string serialized;
+        Run("Serialize/Json", 200, json.size(), [&] {
+            jsonSerializer.Serialize(current, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("SerializeDelta/Json", 200, json.size(), [&] {
+            jsonSerializer.SerializeDelta(previous, current, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/Binary", 2000, json.size(), [&] {
+            binarySerializer.Serialize(current, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("SerializeDelta/Binary", 2000, json.size(), [&] {
+            binarySerializer.SerializeDelta(previous, current, serialized);
+            DoNotOptimize(serialized);
+        });
+
+        auto target = previous;
+        Run("ApplyDelta/Binary", 2000, json.size(), [&] {
+            binarySerializer.ApplyDelta(binaryDelta, target);
+            DoNotOptimize(target);
+        });
+    }
+
+    Registration binaryRegistration("BinarySerializer/Json", RunBinaryBenchmarks);
+    Registration binaryVectorRegistration("BinarySerializer/Vectors", RunBinaryVectorBenchmarks);
+    Registration columnarRegistration("BinarySerializer/Columnar", RunColumnarBenchmarks);
+    Registration deltaRegistration("BinarySerializer/Delta", RunDeltaBenchmarks);
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Cbor;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    // Large numeric arrays make up most of the bytes of telemetry. CBOR writes
+    // them as typed arrays, where JSON writes each element as text.
+    void RunCborVectorBenchmarks()
+    {
+        std::vector<double> doubles(100000);
+        for (std::size_t i = 0; i < doubles.size(); ++i)
+        {
+            doubles[i] = static_cast<double>(i) * 0.1;
+        }
+
+        JsonSerializer jsonSerializer{};
+        CborSerializer cborSerializer;
+        auto json = jsonSerializer.Serialize(doubles);
+        auto cbor = cborSerializer.Serialize(doubles);
+        std::printf("Size/Json %zu bytes, Size/Cbor %zu bytes (%.1fx smaller)\n",
+            json.size(), cbor.size(), static_cast<double>(json.size()) / static_cast<double>(cbor.size()));
+
+        std::string serialized;
+        Run("Serialize/Json/Doubles", 20, json.size(), [&] {
+            jsonSerializer.Serialize(doubles, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/Cbor/Doubles", 2000, json.size(), [&] {
+            cborSerializer.Serialize(doubles, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Json/Doubles", 20, json.size(), [&] {
+            jsonSerializer.DeserializeInto(json, doubles);
+            DoNotOptimize(doubles);
+        });
+        Run("Deserialize/Cbor/Doubles", 2000, json.size(), [&] {
+            cborSerializer.DeserializeInto(cbor, doubles);
+            DoNotOptimize(doubles);
+        });
+    }
+
+    void RunCborBenchmarks()
+    {
+        auto state = MakeWorldState(100);
+        CborSerializer serializer;
+        auto cbor = serializer.Serialize(state);
+        std::string serialized;
+        WorldState target;
+
+        Run("Serialize/Cbor", 5000, cbor.size(), [&] {
+            serializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Deserialize/Cbor", 5000, cbor.size(), [&] {
+            serializer.DeserializeInto(cbor, target);
+            DoNotOptimize(target);
+        });
+    }
+
+    Registration cborRegistration("CborSerializer/WorldState", RunCborBenchmarks);
+    Registration cborVectorRegistration("CborSerializer/Vectors", RunCborVectorBenchmarks);
+}
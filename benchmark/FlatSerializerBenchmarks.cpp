@@ -0,0 +1,71 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Flat;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    // Compares getting at one field of every entity, by deserializing the
+    // JSON or by reading the flat buffer in place.
+    void RunFlatBenchmarks()
+    {
+        auto state = MakeWorldState(1000);
+        JsonSerializer jsonSerializer{};
+        FlatSerializer flatSerializer;
+        auto json = jsonSerializer.Serialize(state);
+        auto flat = flatSerializer.Serialize(state);
+        std::printf("Size/Json %zu bytes, Size/Flat %zu bytes\n", json.size(), flat.size());
+
+        std::string serialized;
+        Run("Serialize/Flat", 200, json.size(), [&] {
+            flatSerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+
+        Run("ReadFuel/Json", 20, json.size(), [&] {
+            auto deserialized = jsonSerializer.Deserialize<WorldState>(json);
+            auto fuel = 0.0;
+            for (auto const& entity : deserialized.entities)
+            {
+                fuel += entity.fuel;
+            }
+
+            DoNotOptimize(fuel);
+        });
+        Run("ReadFuel/FlatView", 2000, json.size(), [&] {
+            FlatView<WorldState> view(flat);
+            auto fuel = 0.0;
+            for (auto entity : view.Get<&WorldState::entities>())
+            {
+                fuel += entity.Get<&Entity::fuel>();
+            }
+
+            DoNotOptimize(fuel);
+        });
+    }
+
+    Registration flatRegistration("FlatSerializer/WorldState", RunFlatBenchmarks);
+}
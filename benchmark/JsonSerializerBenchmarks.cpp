@@ -0,0 +1,203 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <utility>
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    // The document based serialization path: the value is copied into a
+    // rapidjson::Document which is then written out.
+    template <typename TWriter, typename T>
+    std::string SerializeThroughDocument(T value)
+    {
+        rapidjson::Document document;
+        auto json = JsonTypeSerializer<T>::Serialize(document, value);
+        rapidjson::StringBuffer buffer;
+        TWriter writer(buffer);
+        json.Accept(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    // The document based deserialization path: the whole string is parsed
+    // into a rapidjson::Document which is then copied into the value.
+    template <typename T>
+    T DeserializeThroughDocument(std::string const& serialized)
+    {
+        rapidjson::Document document;
+        document.Parse(serialized.c_str());
+        return JsonTypeSerializer<T>::Deserialize(document);
+    }
+
+    void RunSerializeBenchmarks()
+    {
+        auto state = MakeWorldState(100);
+        JsonSerializer serializer{};
+        JsonSerializer prettySerializer{JsonSerializerSettings{ .pretty = true }};
+        auto bytes = serializer.Serialize(state).size();
+        auto prettyBytes = prettySerializer.Serialize(state).size();
+
+        Run("Serialize/Document", 2000, bytes, [&] {
+            DoNotOptimize(SerializeThroughDocument<rapidjson::Writer<rapidjson::StringBuffer>>(state));
+        });
+        Run("Serialize/Streaming", 2000, bytes, [&] {
+            DoNotOptimize(serializer.Serialize(state));
+        });
+        Run("Serialize/Document/Pretty", 2000, prettyBytes, [&] {
+            DoNotOptimize(SerializeThroughDocument<rapidjson::PrettyWriter<rapidjson::StringBuffer>>(state));
+        });
+        Run("Serialize/Streaming/Pretty", 2000, prettyBytes, [&] {
+            DoNotOptimize(prettySerializer.Serialize(state));
+        });
+
+        for (auto [name, numberFormat] : {
+            std::pair{ "Serialize/Streaming/Fixed", JsonNumberFormat::Fixed },
+            std::pair{ "Serialize/Streaming/Float32", JsonNumberFormat::Float32 },
+            std::pair{ "Serialize/Streaming/HexFloat", JsonNumberFormat::HexFloat } })
+        {
+            JsonSerializer formatSerializer{JsonSerializerSettings{ .numberFormat = numberFormat, .maxDecimalPlaces = 3 }};
+            auto formatBytes = formatSerializer.Serialize(state).size();
+            Run(name, 2000, formatBytes, [&] {
+                DoNotOptimize(formatSerializer.Serialize(state));
+            });
+        }
+    }
+
+    void RunSmallMessageBenchmarks()
+    {
+        auto entity = MakeEntity(7);
+        JsonSerializer serializer{};
+        BasicJsonSerializer<> policySerializer{};
+        std::string serialized;
+        auto bytes = serializer.Serialize(entity).size();
+
+        Run("SmallMessage/Document", 200000, bytes, [&] {
+            DoNotOptimize(SerializeThroughDocument<rapidjson::Writer<rapidjson::StringBuffer>>(entity));
+        });
+        Run("SmallMessage/NewSerializer", 200000, bytes, [&] {
+            JsonSerializer newSerializer{};
+            DoNotOptimize(newSerializer.Serialize(entity));
+        });
+        Run("SmallMessage/ReusedSerializer", 200000, bytes, [&] {
+            DoNotOptimize(serializer.Serialize(entity));
+        });
+        Run("SmallMessage/ReusedSerializerAndString", 200000, bytes, [&] {
+            serializer.Serialize(entity, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("SmallMessage/PolicySerializerAndString", 200000, bytes, [&] {
+            policySerializer.Serialize(entity, serialized);
+            DoNotOptimize(serialized);
+        });
+    }
+
+    void RunDeserializeBenchmarks()
+    {
+        JsonSerializer serializer{};
+        auto serialized = serializer.Serialize(MakeWorldState(100));
+
+        Run("Deserialize/Document", 2000, serialized.size(), [&] {
+            DoNotOptimize(DeserializeThroughDocument<WorldState>(serialized));
+        });
+        Run("Deserialize/Streaming", 2000, serialized.size(), [&] {
+            DoNotOptimize(serializer.Deserialize<WorldState>(serialized));
+        });
+    }
+
+    void RunNumericVectorBenchmarks()
+    {
+        JsonSerializer serializer{};
+        std::vector<double> doubles(100000);
+        std::vector<int32_t> integers(100000);
+        for (std::size_t i = 0; i < doubles.size(); ++i)
+        {
+            doubles[i] = static_cast<double>(i) * 0.001 + 1.0 / static_cast<double>(i + 3);
+            integers[i] = static_cast<int32_t>(i * 37) - 1000000;
+        }
+
+        auto serializedDoubles = serializer.Serialize(doubles);
+        auto serializedIntegers = serializer.Serialize(integers);
+
+        Run("NumericVector/Serialize/Doubles", 20, serializedDoubles.size(), [&] {
+            DoNotOptimize(serializer.Serialize(doubles));
+        });
+        Run("NumericVector/Deserialize/Doubles", 20, serializedDoubles.size(), [&] {
+            serializer.DeserializeInto(serializedDoubles, doubles);
+            DoNotOptimize(doubles);
+        });
+        Run("NumericVector/Serialize/Integers", 200, serializedIntegers.size(), [&] {
+            DoNotOptimize(serializer.Serialize(integers));
+        });
+        Run("NumericVector/Deserialize/Integers", 200, serializedIntegers.size(), [&] {
+            serializer.DeserializeInto(serializedIntegers, integers);
+            DoNotOptimize(integers);
+        });
+    }
+
+    void RunPropertyLookupBenchmarks()
+    {
+        JsonSerializer serializer{};
+        auto serialized = serializer.Serialize(WideEntity{});
+        std::vector<std::string> names;
+        ForProperty<WideEntity>([&](auto& property) { names.emplace_back(property.name); });
+
+        Run("PropertyLookup/LinearScan", 20000, 0, [&] {
+            std::size_t sum = 0;
+            for (auto& name : names)
+            {
+                std::size_t index = 0;
+                ForProperty<WideEntity>([&](auto& property) {
+                    if (std::strlen(property.name) == name.size() && std::memcmp(property.name, name.c_str(), name.size()) == 0)
+                    {
+                        sum += index;
+                    }
+
+                    ++index;
+                });
+            }
+
+            DoNotOptimize(sum);
+        });
+        Run("PropertyLookup/PerfectHash", 20000, 0, [&] {
+            std::size_t sum = 0;
+            for (auto& name : names)
+            {
+                sum += PropertyLookup<WideEntity>::Find(name.c_str(), name.size());
+            }
+
+            DoNotOptimize(sum);
+        });
+        Run("Deserialize/WideEntity", 20000, serialized.size(), [&] {
+            DoNotOptimize(serializer.Deserialize<WideEntity>(serialized));
+        });
+    }
+
+    Registration serializeRegistration("JsonSerializer/Serialize", RunSerializeBenchmarks);
+    Registration smallMessageRegistration("JsonSerializer/SmallMessage", RunSmallMessageBenchmarks);
+    Registration deserializeRegistration("JsonSerializer/Deserialize", RunDeserializeBenchmarks);
+    Registration numericVectorRegistration("JsonSerializer/NumericVector", RunNumericVectorBenchmarks);
+    Registration propertyLookupRegistration("JsonSerializer/PropertyLookup", RunPropertyLookupBenchmarks);
+}
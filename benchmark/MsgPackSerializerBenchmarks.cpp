@@ -0,0 +1,65 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Json;
+using namespace OpCoSerializer::MsgPack;
+
+namespace
+{
+    // Compares MessagePack with the JSON encoding of the same value, reporting
+    // the throughput of each relative to the size of the value's JSON.
+    void RunMsgPackBenchmarks()
+    {
+        auto state = MakeWorldState(100);
+        JsonSerializer jsonSerializer{};
+        MsgPackSerializer msgPackSerializer;
+        auto json = jsonSerializer.Serialize(state);
+        auto msgPack = msgPackSerializer.Serialize(state);
+        std::printf("Size/Json %zu bytes, Size/MsgPack %zu bytes (%.1fx smaller)\n",
+            json.size(), msgPack.size(), static_cast<double>(json.size()) / static_cast<double>(msgPack.size()));
+
+        std::string serialized;
+        Run("Serialize/Json", 2000, json.size(), [&] {
+            jsonSerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+        Run("Serialize/MsgPack", 5000, json.size(), [&] {
+            msgPackSerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+
+        WorldState target;
+        Run("Deserialize/Json", 2000, json.size(), [&] {
+            jsonSerializer.DeserializeInto(json, target);
+            DoNotOptimize(target);
+        });
+        Run("Deserialize/MsgPack", 5000, json.size(), [&] {
+            msgPackSerializer.DeserializeInto(msgPack, target);
+            DoNotOptimize(target);
+        });
+    }
+
+    Registration msgPackRegistration("MsgPackSerializer/Json", RunMsgPackBenchmarks);
+}
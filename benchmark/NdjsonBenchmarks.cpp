@@ -0,0 +1,105 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <thread>
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    std::string MakeRecords(int count)
+    {
+        NdjsonWriter<Entity> writer;
+        for (auto i = 0; i < count; ++i)
+        {
+            writer.Write(MakeEntity(i));
+        }
+
+        return std::string(writer.View());
+    }
+
+    void RunNdjsonBenchmarks()
+    {
+        auto entity = MakeEntity(7);
+        auto records = MakeRecords(100000);
+        JsonSerializer serializer{};
+
+        Run("Ndjson/Write/SerializePerRecord", 200000, 0, [&] {
+            std::string concatenated;
+            for (auto i = 0; i < 8; ++i)
+            {
+                concatenated += serializer.Serialize(entity);
+                concatenated += '\n';
+            }
+
+            DoNotOptimize(concatenated);
+        });
+        NdjsonWriter<Entity> writer;
+        Run("Ndjson/Write/NdjsonWriter", 200000, 0, [&] {
+            writer.Clear();
+            for (auto i = 0; i < 8; ++i)
+            {
+                writer.Write(entity);
+            }
+
+            DoNotOptimize(writer.View());
+        });
+
+        Run("Ndjson/Read/NdjsonReader", 10, records.size(), [&] {
+            NdjsonReader<Entity> reader(records);
+            Entity record;
+            std::size_t count = 0;
+            while (reader.Next(record))
+            {
+                ++count;
+            }
+
+            DoNotOptimize(count);
+        });
+    }
+
+    // Reports the throughput of reading the same records with increasing
+    // numbers of threads. Scaling is bounded by the cores available.
+    void RunNdjsonParallelBenchmarks()
+    {
+        auto records = MakeRecords(400000);
+        auto hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        std::printf("Hardware threads: %u\n", hardwareThreads);
+
+        auto single = 0.0;
+        for (std::size_t threads = 1; threads <= 16; threads *= 2)
+        {
+            auto name = "Ndjson/ReadParallel/" + std::to_string(threads);
+            auto nanoseconds = Run(name, 5, records.size(), [&] {
+                DoNotOptimize(ReadNdjsonParallel<Entity>(records, threads));
+            });
+
+            single = threads == 1 ? nanoseconds : single;
+            std::printf("%-48s %12.2fx\n", (name + "/Speedup").c_str(), single / nanoseconds);
+        }
+    }
+
+    Registration ndjsonRegistration("Ndjson/Sequential", RunNdjsonBenchmarks);
+    Registration ndjsonParallelRegistration("Ndjson/Parallel", RunNdjsonParallelBenchmarks);
+}
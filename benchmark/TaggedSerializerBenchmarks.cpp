@@ -0,0 +1,56 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Benchmark.hpp"
+#include "BenchmarkTypes.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Benchmark;
+using namespace OpCoSerializer::Binary;
+using namespace OpCoSerializer::Tagged;
+
+namespace
+{
+    // Compares the tagged encoding, which tolerates added and removed fields,
+    // with the fixed binary encoding of the same value.
+    void RunTaggedBenchmarks()
+    {
+        auto state = MakeWorldState(100);
+        BinarySerializer binarySerializer;
+        TaggedSerializer taggedSerializer;
+        auto binary = binarySerializer.Serialize(state);
+        auto tagged = taggedSerializer.Serialize(state);
+        std::printf("Size/Binary %zu bytes, Size/Tagged %zu bytes\n", binary.size(), tagged.size());
+
+        std::string serialized;
+        Run("Serialize/Tagged", 5000, tagged.size(), [&] {
+            taggedSerializer.Serialize(state, serialized);
+            DoNotOptimize(serialized);
+        });
+
+        WorldState target;
+        Run("Deserialize/Tagged", 5000, tagged.size(), [&] {
+            taggedSerializer.DeserializeInto(tagged, target);
+            DoNotOptimize(target);
+        });
+    }
+
+    Registration taggedRegistration("TaggedSerializer/WorldState", RunTaggedBenchmarks);
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BINARY_DELTA_HPP
+#define OPCOSERIALIZER_BINARY_DELTA_HPP
+
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Binary/BinaryStreams.hpp"
+#include "OpCoSerializer/Binary/BinaryTypeSerializer.hpp"
+
+namespace OpCoSerializer::Binary
+{
+    /// Writes the changes between two values of the same type, such that
+    /// applying them to the previous value with ApplyBinaryDelta gives the
+    /// current value.
+    /// @remarks Values with serializable properties are written as the index
+    /// plus one of each changed property followed by its delta, ending with a
+    /// zero. Vectors are written as their size, then the index plus one of
+    /// each changed element followed by its delta (or its value if it is new),
+    /// ending with a zero. Any other value is written in full.
+    /// @tparam T The type of the values.
+    /// @param writer The writer.
+    /// @param previous The previous value.
+    /// @param current The current value.
+    template <typename T>
+    void WriteBinaryDelta(BinaryWriter& writer, T const& previous, T const& current)
+    {
+        if constexpr (HasSerializablePropertiesV<T>)
+        {
+            std::size_t index = 0;
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                ++index;
+                if (!SerializedEqual<Type>(previous.*(property.member), current.*(property.member)))
+                {
+                    writer.WriteSize(index);
+                    WriteBinaryDelta<Type>(writer, previous.*(property.member), current.*(property.member));
+                }
+            });
+
+            writer.WriteSize(0);
+        }
+        else if constexpr (IsVectorV<T>)
+        {
+            using TElement = typename T::value_type;
+
+            writer.WriteSize(current.size());
+            for (std::size_t i = 0; i < current.size(); ++i)
+            {
+                if (i >= previous.size())
+                {
+                    writer.WriteSize(i + 1);
+                    WriteBinary<TElement>(writer, current[i]);
+                }
+                else if (!SerializedEqual<TElement>(previous[i], current[i]))
+                {
+                    writer.WriteSize(i + 1);
+                    WriteBinaryDelta<TElement>(writer, previous[i], current[i]);
+                }
+            }
+
+            writer.WriteSize(0);
+        }
+        else
+        {
+            WriteBinary<T>(writer, current);
+        }
+    }
+
+    /// Applies changes written by WriteBinaryDelta to a value, patching it in
+    /// place.
+    /// @remarks The value must equal the previous value the delta was written
+    /// from.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @param value The value to patch.
+    template <typename T>
+    void ApplyBinaryDelta(BinaryReader& reader, T& value)
+    {
+        if constexpr (HasSerializablePropertiesV<T>)
+        {
+            for (auto index = reader.ReadSize(); index != 0; index = reader.ReadSize())
+            {
+                if (index > PropertyCountV<T>)
+                {
+                    throw OpCoSerializerException("Invalid property in binary delta");
+                }
+
+                ForPropertyAt<T>(index - 1, [&](auto& property) {
+                    ApplyBinaryDelta(reader, value.*(property.member));
+                });
+            }
+        }
+        else if constexpr (IsVectorV<T>)
+        {
+            using TElement = typename T::value_type;
+
+            auto size = reader.ReadSize();
+            while (value.size() > size)
+            {
+                value.pop_back();
+            }
+
+            // Elements up to the previous size are patched, and any after are
+            // appended in order.
+            auto existing = value.size();
+            for (auto index = reader.ReadSize(); index != 0; index = reader.ReadSize())
+            {
+                if (index <= existing)
+                {
+                    if constexpr (std::is_same_v<TElement, bool>)
+                    {
+                        bool element = value[index - 1];
+                        ApplyBinaryDelta(reader, element);
+                        value[index - 1] = element;
+                    }
+                    else
+                    {
+                        ApplyBinaryDelta(reader, value[index - 1]);
+                    }
+                }
+                else if (index == value.size() + 1 && index <= size)
+                {
+                    value.push_back(ReadBinaryValue<TElement>(reader));
+                }
+                else
+                {
+                    throw OpCoSerializerException("Invalid vector element in binary delta");
+                }
+            }
+
+            if (value.size() != size)
+            {
+                throw OpCoSerializerException("Invalid vector in binary delta - missing elements");
+            }
+        }
+        else
+        {
+            ReadBinary(reader, value);
+        }
+    }
+}
+
+#endif // OPCOSERIALIZER_BINARY_DELTA_HPP
@@ -0,0 +1,150 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BINARY_SERIALIZER_HPP
+#define OPCOSERIALIZER_BINARY_SERIALIZER_HPP
+
+#include <string>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Binary/BinaryStreams.hpp"
+#include "OpCoSerializer/Binary/BinaryTypeSerializer.hpp"
+#include "OpCoSerializer/Binary/BinaryDelta.hpp"
+
+namespace OpCoSerializer::Binary
+{
+    /// Serializes objects to and from a compact binary encoding.
+    /// @remarks Properties are written in order without names, numbers in
+    /// little endian byte order, and strings and vectors are prefixed with
+    /// their length. Both sides must therefore agree on the properties of
+    /// each type.
+    class BinarySerializer final
+    {
+        public:
+            /// Serializes the given value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @returns The serialized bytes.
+            template <typename T>
+            std::string Serialize(T const& value)
+            {
+                std::string serialized;
+                Serialize(value, serialized);
+                return serialized;
+            }
+
+            /// Serializes the given value into an existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                serialized.clear();
+                BinaryWriter writer(serialized);
+                WriteBinary(writer, value);
+            }
+
+            /// Deserializes the bytes to a value of type T.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @returns The deserialized value.
+            template <typename T>
+            T Deserialize(std::string_view serialized)
+            {
+                BinaryReader reader(serialized);
+                auto value = ReadBinaryValue<T>(reader);
+                CheckAtEnd(reader);
+                return value;
+            }
+
+            /// Deserializes the bytes into an existing value, overwriting its
+            /// members in place and reusing their storage.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @param target The value to deserialize into.
+            template <typename T>
+            void DeserializeInto(std::string_view serialized, T& target)
+            {
+                BinaryReader reader(serialized);
+                ReadBinary(reader, target);
+                CheckAtEnd(reader);
+            }
+
+            /// Serializes the changes from one value to another.
+            /// @remarks Only the properties and vector elements which differ
+            /// are written, recursively (see WriteBinaryDelta), so a stream of
+            /// values which change little can be stored as a full value
+            /// followed by deltas.
+            /// @tparam T the type of the values.
+            /// @param previous The previous value.
+            /// @param current The current value.
+            /// @returns The serialized delta.
+            template <typename T>
+            std::string SerializeDelta(T const& previous, T const& current)
+            {
+                std::string serialized;
+                SerializeDelta(previous, current, serialized);
+                return serialized;
+            }
+
+            /// Serializes the changes from one value to another into an
+            /// existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the values.
+            /// @param previous The previous value.
+            /// @param current The current value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+            void SerializeDelta(T const& previous, T const& current, std::string& serialized)
+            {
+                serialized.clear();
+                BinaryWriter writer(serialized);
+                WriteBinaryDelta(writer, previous, current);
+            }
+
+            /// Applies a delta written by SerializeDelta, patching the value in
+            /// place.
+            /// @remarks The value must equal the previous value that the delta
+            /// was serialized from, after which it equals the current value.
+            /// @tparam T the type of the value.
+            /// @param delta The serialized delta.
+            /// @param target The value to patch.
+            template <typename T>
+            void ApplyDelta(std::string_view delta, T& target)
+            {
+                BinaryReader reader(delta);
+                ApplyBinaryDelta(reader, target);
+                CheckAtEnd(reader);
+            }
+
+        private:
+            static void CheckAtEnd(BinaryReader const& reader)
+            {
+                if (reader.Remaining() != 0)
+                {
+                    throw OpCoSerializerException("Unexpected binary data after the end of the deserialized value");
+                }
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_BINARY_SERIALIZER_HPP
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BINARY_STREAMS_HPP
+#define OPCOSERIALIZER_BINARY_STREAMS_HPP
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::Binary
+{
+    /// Appends the binary encoding of values to a string.
+    /// @remarks Numbers are written in little endian byte order, and sizes as
+    /// unsigned LEB128 variable length integers.
+    class BinaryWriter final
+    {
+        public:
+            /// Initializes a new instance of the BinaryWriter type.
+            /// @param output The string to append to.
+            explicit BinaryWriter(std::string& output)
+                : _output(output)
+            {
+            }
+
+            /// Appends raw bytes.
+            /// @param data The bytes.
+            /// @param size The number of bytes.
+            void WriteBytes(void const* data, std::size_t size)
+            {
+                _output.append(static_cast<char const*>(data), size);
+            }
+
+            /// Appends bytes which are then filled in by the caller.
+            /// @param size The number of bytes.
+            /// @returns The appended bytes, which are valid until the next write.
+            char* Extend(std::size_t size)
+            {
+                auto offset = _output.size();
+                _output.resize(offset + size);
+                return _output.data() + offset;
+            }
+
+            /// Appends a number in little endian byte order.
+            /// @param value The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            void Write(T value)
+            {
+                auto littleEndian = NativeToLittleEndian(value);
+                WriteBytes(&littleEndian, sizeof(T));
+            }
+
+            /// Appends a size, e.g. the length of a string or vector.
+            /// @param size The size.
+            void WriteSize(std::size_t size)
+            {
+                char bytes[10];
+                std::size_t count = 0;
+                do
+                {
+                    auto byte = static_cast<unsigned char>(size & 0x7F);
+                    size >>= 7;
+                    bytes[count++] = static_cast<char>(size != 0 ? byte | 0x80 : byte);
+                } while (size != 0);
+
+                WriteBytes(bytes, count);
+            }
+
+        private:
+            std::string& _output;
+    };
+
+    /// Reads binary encoded values from a buffer, as written by a BinaryWriter.
+    /// @remarks Every read is bounds checked, throwing an OpCoSerializerException
+    /// rather than reading beyond the end of the buffer.
+    class BinaryReader final
+    {
+        public:
+            /// Initializes a new instance of the BinaryReader type.
+            /// @param input The buffer. Must outlive the reader.
+            explicit BinaryReader(std::string_view input)
+                : _position(input.data()),
+                  _end(input.data() + input.size())
+            {
+            }
+
+            /// Reads raw bytes.
+            /// @param size The number of bytes.
+            /// @returns The bytes, which remain in the buffer.
+            char const* ReadBytes(std::size_t size)
+            {
+                if (size > Remaining())
+                {
+                    throw OpCoSerializerException("Unexpected end of binary data during deserialization");
+                }
+
+                auto bytes = _position;
+                _position += size;
+                return bytes;
+            }
+
+            /// Reads a number in little endian byte order.
+            /// @returns The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            T Read()
+            {
+                T value;
+                std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+                return NativeToLittleEndian(value);
+            }
+
+            /// Reads a size, e.g. the length of a string or vector.
+            /// @returns The size.
+            std::size_t ReadSize()
+            {
+                uint64_t size = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7)
+                {
+                    auto byte = static_cast<unsigned char>(*ReadBytes(1));
+                    size |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return static_cast<std::size_t>(size);
+                    }
+                }
+
+                throw OpCoSerializerException("Invalid size in binary data during deserialization");
+            }
+
+            /// Gets the number of bytes left to read.
+            /// @returns The number of bytes.
+            std::size_t Remaining() const
+            {
+                return static_cast<std::size_t>(_end - _position);
+            }
+
+        private:
+            char const* _position;
+            char const* _end;
+    };
+}
+
+#endif // OPCOSERIALIZER_BINARY_STREAMS_HPP
@@ -0,0 +1,443 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_BINARY_TYPE_SERIALIZER_HPP
+#define OPCOSERIALIZER_BINARY_TYPE_SERIALIZER_HPP
+
+#include <bit>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Binary/BinaryStreams.hpp"
+
+namespace OpCoSerializer::Binary
+{
+    template <typename T>
+    struct BinaryTypeSerializer;
+
+    /// Checks whether or not the binary encoding of T is its object
+    /// representation, so that values (and vectors of them) can be written
+    /// and read with a single copy.
+    /// @remarks This holds for numbers other than bool, enums, and structs
+    /// whose properties match their layout (see PropertiesMatchLayout) and
+    /// are themselves bulk copyable, as long as they use the default
+    /// BinaryTypeSerializer. It never holds on big endian platforms, where
+    /// every number is byte swapped.
+    /// @tparam T The type to check.
+    template <typename T>
+    class IsBulkCopyable final
+    {
+        private:
+            static constexpr bool Check()
+            {
+                if constexpr (std::endian::native != std::endian::little || std::is_same_v<T, bool>)
+                {
+                    return false;
+                }
+                else if constexpr (!requires { typename BinaryTypeSerializer<T>::DefaultEncoding; })
+                {
+                    return false;
+                }
+                else if constexpr (std::is_arithmetic_v<T>)
+                {
+                    return true;
+                }
+                else if constexpr (std::is_enum_v<T>)
+                {
+                    return !std::is_same_v<std::underlying_type_t<T>, bool>;
+                }
+                else if constexpr (PropertiesMatchLayoutV<T>)
+                {
+                    bool bulkCopyable = true;
+                    ForProperty<T>([&](auto& property) {
+                        using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                        using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                        bulkCopyable = bulkCopyable && IsBulkCopyable<Type>::value;
+                    });
+
+                    return bulkCopyable;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+        public:
+            static constexpr bool value = Check();
+    };
+
+    /// Helper for the value of IsBulkCopyable<T>.
+    template <typename T>
+    bool constexpr IsBulkCopyableV = IsBulkCopyable<T>::value;
+
+    /// Writes the binary encoding of the given value.
+    /// @tparam T The type of the value.
+    /// @param writer The writer.
+    /// @param value The value.
+    template <typename T>
+    void WriteBinary(BinaryWriter& writer, T const& value)
+    {
+        BinaryTypeSerializer<T>::Write(writer, value);
+    }
+
+    /// Reads a value into an existing instance, reusing its storage.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @param value The value to read into.
+    template <typename T>
+    void ReadBinary(BinaryReader& reader, T& value)
+    {
+        BinaryTypeSerializer<T>::Read(reader, value);
+    }
+
+    /// Reads a new value.
+    /// @remarks Types without a default constructor are constructed from the
+    /// values of their properties, otherwise a value initialized instance is
+    /// read into.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @returns The value.
+    template <typename T>
+    T ReadBinaryValue(BinaryReader& reader)
+    {
+        if constexpr (IsConstructedFromPropertiesV<T>)
+        {
+            return BinaryTypeSerializer<T>::Construct(reader);
+        }
+        else
+        {
+            T value{};
+            ReadBinary(reader, value);
+            return value;
+        }
+    }
+
+    /// Provides binary serialization and deserialization logic for a type.
+    /// @remarks Specialize this type in order to be able serialize or
+    /// deserialize any type of data. By default, this type will support:
+    /// - Numeric, boolean and enum types, in little endian byte order.
+    /// - Types that have OpCoSerializer properties that are recursively
+    /// serializable. Properties are written in order without names, so the
+    /// encoding changes if properties are added, removed or reordered.
+    /// @tparam T The type.
+    template <typename T>
+    struct BinaryTypeSerializer
+    {
+        /// Marks the default encoding, which specializations do not have.
+        using DefaultEncoding = void;
+
+        /// Writes the given value.
+        /// @param writer The writer.
+        /// @param value The value.
+        static void Write(BinaryWriter& writer, T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T> && IsBulkCopyableV<T>)
+            {
+                writer.WriteBytes(&value, sizeof(T));
+            }
+            else if constexpr (HasSerializablePropertiesV<T>)
+            {
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    WriteBinary<Type>(writer, value.*(property.member));
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                writer.Write(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T>, "BinaryTypeSerializer must be specialized for this type");
+                writer.Write(value);
+            }
+        }
+
+        /// Reads a value into an existing instance.
+        /// @param reader The reader.
+        /// @param value The value to read into.
+        static void Read(BinaryReader& reader, T& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T> && IsBulkCopyableV<T>)
+            {
+                std::memcpy(&value, reader.ReadBytes(sizeof(T)), sizeof(T));
+            }
+            else if constexpr (HasSerializablePropertiesV<T>)
+            {
+                ForProperty<T>([&](auto& property) {
+                    ReadBinary(reader, value.*(property.member));
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                value = static_cast<T>(reader.Read<std::underlying_type_t<T>>());
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                value = reader.Read<uint8_t>() != 0;
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T>, "BinaryTypeSerializer must be specialized for this type");
+                value = reader.Read<T>();
+            }
+        }
+
+        /// Reads a value by constructing it once from the values of its
+        /// properties, for types without a default constructor.
+        /// @param reader The reader.
+        /// @returns The value.
+        static T Construct(BinaryReader& reader)
+        {
+            PropertyValuesT<T> values;
+            ForSequence(std::make_index_sequence<PropertyCountV<T>>{}, [&](auto i) {
+                auto& propertyValue = std::get<i>(values);
+                using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                propertyValue.emplace(ReadBinaryValue<Type>(reader));
+            });
+
+            return ConstructFromProperties<T>(values, true);
+        }
+    };
+
+    /// Partial BinaryTypeSerializer specialization for a vector of a given type.
+    /// @remarks The number of elements is written, followed by each element.
+    /// Vectors of bulk copyable elements are written and read with a single
+    /// copy of their contiguous storage.
+    template <typename TElement>
+    struct BinaryTypeSerializer<std::vector<TElement>>
+    {
+        static void Write(BinaryWriter& writer, std::vector<TElement> const& value)
+        {
+            writer.WriteSize(value.size());
+            if constexpr (IsBulkCopyableV<TElement>)
+            {
+                writer.WriteBytes(value.data(), value.size() * sizeof(TElement));
+                return;
+            }
+
+            for (auto const& element : value)
+            {
+                WriteBinary<TElement>(writer, element);
+            }
+        }
+
+        /// @remarks Existing elements are read into in place, reusing their
+        /// storage, and any left over are removed.
+        static void Read(BinaryReader& reader, std::vector<TElement>& value)
+        {
+            auto size = reader.ReadSize();
+
+            if constexpr (IsBulkCopyableV<TElement>)
+            {
+                if (size > reader.Remaining() / sizeof(TElement))
+                {
+                    throw OpCoSerializerException("Unexpected end of binary data during deserialization");
+                }
+
+                auto bytes = reader.ReadBytes(size * sizeof(TElement));
+                value.resize(size);
+                if (size != 0)
+                {
+                    std::memcpy(value.data(), bytes, size * sizeof(TElement));
+                }
+
+                return;
+            }
+
+            // Every element takes at least one byte, except for types without
+            // any properties, so a corrupt size cannot reserve huge amounts of
+            // memory.
+            if constexpr (HasSerializablePropertiesV<TElement>)
+            {
+                if constexpr (PropertyCountV<TElement> == 0)
+                {
+                    value.resize(size);
+                    return;
+                }
+            }
+
+            if (size > reader.Remaining())
+            {
+                throw OpCoSerializerException("Unexpected end of binary data during deserialization");
+            }
+
+            if constexpr (IsConstructedFromPropertiesV<TElement>)
+            {
+                value.clear();
+            }
+
+            while (value.size() > size)
+            {
+                value.pop_back();
+            }
+
+            value.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if constexpr (std::is_same_v<TElement, bool>)
+                {
+                    bool element = false;
+                    ReadBinary(reader, element);
+                    if (i < value.size())
+                    {
+                        value[i] = element;
+                    }
+                    else
+                    {
+                        value.push_back(element);
+                    }
+                }
+                else if constexpr (IsConstructedFromPropertiesV<TElement>)
+                {
+                    value.push_back(ReadBinaryValue<TElement>(reader));
+                }
+                else if (i < value.size())
+                {
+                    ReadBinary(reader, value[i]);
+                }
+                else
+                {
+                    ReadBinary(reader, value.emplace_back());
+                }
+            }
+        }
+    };
+
+    /// Partial BinaryTypeSerializer specialization for a columnar vector.
+    /// @remarks The number of elements is written, followed by a column per
+    /// property holding the value of that property for every element. Columns
+    /// of bulk copyable values are gathered into (and scattered from) their
+    /// contiguous bytes in one pass, rather than written value by value.
+    /// @tparam T The type of the elements.
+    template <typename T>
+    struct BinaryTypeSerializer<Columnar<T>>
+    {
+        static void Write(BinaryWriter& writer, Columnar<T> const& value)
+        {
+            writer.WriteSize(value.size());
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                if constexpr (IsBulkCopyableV<Type>)
+                {
+                    auto bytes = writer.Extend(value.size() * sizeof(Type));
+                    for (auto const& row : value)
+                    {
+                        std::memcpy(bytes, &(row.*(property.member)), sizeof(Type));
+                        bytes += sizeof(Type);
+                    }
+                }
+                else
+                {
+                    for (auto const& row : value)
+                    {
+                        WriteBinary<Type>(writer, row.*(property.member));
+                    }
+                }
+            });
+        }
+
+        /// @remarks Existing elements are read into in place, reusing their
+        /// storage, and any left over are removed.
+        static void Read(BinaryReader& reader, Columnar<T>& value)
+        {
+            auto size = reader.ReadSize();
+
+            // Every element takes at least one byte, except for types without
+            // any properties, so a corrupt size cannot reserve huge amounts of
+            // memory.
+            if (size > reader.Remaining() && PropertyCountV<T> != 0)
+            {
+                throw OpCoSerializerException("Unexpected end of binary data during deserialization");
+            }
+
+            value.resize(size);
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                if constexpr (IsBulkCopyableV<Type>)
+                {
+                    if (size > reader.Remaining() / sizeof(Type))
+                    {
+                        throw OpCoSerializerException("Unexpected end of binary data during deserialization");
+                    }
+
+                    auto bytes = reader.ReadBytes(size * sizeof(Type));
+                    for (auto& row : value)
+                    {
+                        std::memcpy(&(row.*(property.member)), bytes, sizeof(Type));
+                        bytes += sizeof(Type);
+                    }
+                }
+                else
+                {
+                    for (auto& row : value)
+                    {
+                        ReadBinary(reader, row.*(property.member));
+                    }
+                }
+            });
+        }
+    };
+
+    /// BinaryTypeSerializer specialization for a C++ string.
+    /// @remarks The length is written, followed by the characters.
+    template <>
+    struct BinaryTypeSerializer<std::string>
+    {
+        static void Write(BinaryWriter& writer, std::string const& value)
+        {
+            writer.WriteSize(value.size());
+            writer.WriteBytes(value.data(), value.size());
+        }
+
+        static void Read(BinaryReader& reader, std::string& value)
+        {
+            auto size = reader.ReadSize();
+            value.assign(reader.ReadBytes(size), size);
+        }
+    };
+
+    /// BinaryTypeSerializer specialization for a C++ string view.
+    /// @remarks Deserialized views refer to the characters in the buffer being
+    /// deserialized, so the buffer must outlive them.
+    template <>
+    struct BinaryTypeSerializer<std::string_view>
+    {
+        static void Write(BinaryWriter& writer, std::string_view const& value)
+        {
+            writer.WriteSize(value.size());
+            writer.WriteBytes(value.data(), value.size());
+        }
+
+        static void Read(BinaryReader& reader, std::string_view& value)
+        {
+            auto size = reader.ReadSize();
+            value = std::string_view(reader.ReadBytes(size), size);
+        }
+    };
+}
+
+#endif // OPCOSERIALIZER_BINARY_TYPE_SERIALIZER_HPP
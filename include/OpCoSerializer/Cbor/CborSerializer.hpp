@@ -0,0 +1,120 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_CBOR_SERIALIZER_HPP
+#define OPCOSERIALIZER_CBOR_SERIALIZER_HPP
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Cbor/CborStreams.hpp"
+#include "OpCoSerializer/Cbor/CborTypeSerializer.hpp"
+
+namespace OpCoSerializer::Cbor
+{
+    /// Configuration for a CborSerializer.
+    struct CborSerializerSettings final
+    {
+        /// Indicates when deserializing, if a member is not present,
+        /// whether or not an exception should be thrown. 
+        bool propertiesRequired = false;
+    };
+
+    /// Serializes objects to and from CBOR (RFC 8949).
+    /// @remarks Objects are written as maps keyed by property name, in the
+    /// same shape as the JSON written by a JsonSerializer, except that vectors
+    /// of numbers are written as RFC 8746 typed arrays. Values are decoded
+    /// straight into their members without an intermediate tree.
+    class CborSerializer final
+    {
+        public:
+            /// Initializes a new instance of the CborSerializer type.
+            /// @param settings The settings to use.
+            explicit CborSerializer(CborSerializerSettings&& settings = CborSerializerSettings{})
+                : _settings(std::move(settings))
+            {
+            }
+
+            /// Serializes the given value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @returns The serialized bytes.
+            template <typename T>
+            std::string Serialize(T const& value)
+            {
+                std::string serialized;
+                Serialize(value, serialized);
+                return serialized;
+            }
+
+            /// Serializes the given value into an existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                serialized.clear();
+                CborWriter writer(serialized);
+                WriteCbor(writer, value);
+            }
+
+            /// Deserializes the bytes to a value of type T.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @returns The deserialized value.
+            template <typename T>
+            T Deserialize(std::string_view serialized)
+            {
+                CborReader reader(serialized, _settings.propertiesRequired);
+                auto value = ReadCborValue<T>(reader);
+                CheckAtEnd(reader);
+                return value;
+            }
+
+            /// Deserializes the bytes into an existing value, overwriting its
+            /// members in place and reusing their storage.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @param target The value to deserialize into.
+            template <typename T>
+            void DeserializeInto(std::string_view serialized, T& target)
+            {
+                CborReader reader(serialized, _settings.propertiesRequired);
+                ReadCbor(reader, target);
+                CheckAtEnd(reader);
+            }
+
+        private:
+            CborSerializerSettings _settings;
+
+            static void CheckAtEnd(CborReader const& reader)
+            {
+                if (reader.Remaining() != 0)
+                {
+                    throw OpCoSerializerException("Unexpected CBOR data after the end of the deserialized value");
+                }
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_CBOR_SERIALIZER_HPP
@@ -0,0 +1,534 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_CBOR_STREAMS_HPP
+#define OPCOSERIALIZER_CBOR_STREAMS_HPP
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::Cbor
+{
+    /// The major type of a CBOR data item, in the top three bits of its
+    /// initial byte.
+    enum class CborMajorType : uint8_t
+    {
+        Unsigned = 0,
+        Negative = 1,
+        ByteString = 2,
+        TextString = 3,
+        Array = 4,
+        Map = 5,
+        Tag = 6,
+        Simple = 7
+    };
+
+    /// Appends CBOR (RFC 8949) encoded data items to a string.
+    /// @remarks Integers, lengths and tags always use the shortest form of
+    /// their argument, and floating point numbers are written in single
+    /// precision when that is exact.
+    class CborWriter final
+    {
+        public:
+            /// Initializes a new instance of the CborWriter type.
+            /// @param output The string to append to.
+            explicit CborWriter(std::string& output)
+                : _output(output)
+            {
+            }
+
+            /// Appends a boolean.
+            /// @param value The boolean.
+            void WriteBool(bool value)
+            {
+                WriteByte(value ? 0xf5 : 0xf4);
+            }
+
+            /// Appends an integer.
+            /// @param value The integer.
+            template <typename T>
+                requires std::is_integral_v<T>
+            void WriteInteger(T value)
+            {
+                if constexpr (std::is_signed_v<T>)
+                {
+                    if (value < 0)
+                    {
+                        // Negative integers are encoded as -1 - n.
+                        WriteHead(CborMajorType::Negative, static_cast<uint64_t>(-1 - static_cast<int64_t>(value)));
+                        return;
+                    }
+                }
+
+                WriteHead(CborMajorType::Unsigned, static_cast<uint64_t>(value));
+            }
+
+            /// Appends a floating point number, in single precision if that is exact.
+            /// @param value The number.
+            template <typename T>
+                requires std::is_floating_point_v<T>
+            void WriteFloat(T value)
+            {
+                auto constexpr floatMax = static_cast<double>(std::numeric_limits<float>::max());
+                auto number = static_cast<double>(value);
+                if (!std::isfinite(number)
+                    || (std::fabs(number) <= floatMax && static_cast<double>(static_cast<float>(number)) == number))
+                {
+                    WriteByte(0xfa);
+                    WriteBigEndian(static_cast<float>(number));
+                }
+                else
+                {
+                    WriteByte(0xfb);
+                    WriteBigEndian(number);
+                }
+            }
+
+            /// Appends a text string.
+            /// @param data The UTF-8 characters. Do not need to be null terminated.
+            /// @param length The number of characters.
+            void WriteString(char const* data, std::size_t length)
+            {
+                WriteHead(CborMajorType::TextString, length);
+                _output.append(data, length);
+            }
+
+            /// Appends a byte string.
+            /// @param data The bytes.
+            /// @param size The number of bytes.
+            void WriteByteString(void const* data, std::size_t size)
+            {
+                WriteHead(CborMajorType::ByteString, size);
+                _output.append(static_cast<char const*>(data), size);
+            }
+
+            /// Appends the header of an array, which must be followed by its elements.
+            /// @param size The number of elements.
+            void WriteArrayHeader(std::size_t size)
+            {
+                WriteHead(CborMajorType::Array, size);
+            }
+
+            /// Appends the header of a map, which must be followed by its keys
+            /// and values in turn.
+            /// @param size The number of key value pairs.
+            void WriteMapHeader(std::size_t size)
+            {
+                WriteHead(CborMajorType::Map, size);
+            }
+
+            /// Appends a tag, which must be followed by the data item it tags.
+            /// @param tag The tag number.
+            void WriteTag(uint64_t tag)
+            {
+                WriteHead(CborMajorType::Tag, tag);
+            }
+
+        private:
+            std::string& _output;
+
+            void WriteByte(unsigned char byte)
+            {
+                _output.push_back(static_cast<char>(byte));
+            }
+
+            template <typename T>
+            void WriteBigEndian(T value)
+            {
+                auto bigEndian = NativeToBigEndian(value);
+                _output.append(reinterpret_cast<char const*>(&bigEndian), sizeof(T));
+            }
+
+            void WriteHead(CborMajorType type, uint64_t argument)
+            {
+                auto major = static_cast<unsigned char>(static_cast<unsigned char>(type) << 5);
+                if (argument < 24)
+                {
+                    WriteByte(static_cast<unsigned char>(major | argument));
+                }
+                else if (argument <= std::numeric_limits<uint8_t>::max())
+                {
+                    WriteByte(major | 24);
+                    WriteBigEndian(static_cast<uint8_t>(argument));
+                }
+                else if (argument <= std::numeric_limits<uint16_t>::max())
+                {
+                    WriteByte(major | 25);
+                    WriteBigEndian(static_cast<uint16_t>(argument));
+                }
+                else if (argument <= std::numeric_limits<uint32_t>::max())
+                {
+                    WriteByte(major | 26);
+                    WriteBigEndian(static_cast<uint32_t>(argument));
+                }
+                else
+                {
+                    WriteByte(major | 27);
+                    WriteBigEndian(argument);
+                }
+            }
+    };
+
+    /// Reads CBOR encoded data items from a buffer, one at a time, without
+    /// building an intermediate tree.
+    /// @remarks Every read is bounds checked, throwing an OpCoSerializerException
+    /// rather than reading beyond the end of the buffer. Any encoding may be
+    /// read for a number, including half precision, as long as the value fits
+    /// in the requested type. Indefinite length items are not supported.
+    class CborReader final
+    {
+        public:
+            /// Initializes a new instance of the CborReader type.
+            /// @param input The buffer. Must outlive the reader.
+            /// @param propertiesRequired Whether or not all properties of the
+            /// outermost object must be present.
+            explicit CborReader(std::string_view input, bool propertiesRequired = false)
+                : _position(input.data()),
+                  _end(input.data() + input.size()),
+                  _propertiesRequired(propertiesRequired)
+            {
+            }
+
+            /// Gets the major type of the next data item without reading it.
+            /// @returns The major type.
+            CborMajorType PeekMajorType() const
+            {
+                if (Remaining() == 0)
+                {
+                    ThrowEndOfData();
+                }
+
+                return static_cast<CborMajorType>(static_cast<unsigned char>(*_position) >> 5);
+            }
+
+            /// Reads a boolean.
+            /// @returns The boolean.
+            bool ReadBool()
+            {
+                auto byte = ReadByte();
+                if (byte != 0xf4 && byte != 0xf5)
+                {
+                    ThrowUnexpected("a boolean");
+                }
+
+                return byte == 0xf5;
+            }
+
+            /// Reads a number, checking that it fits in T.
+            /// @remarks Integers may be read as floating point numbers, but not
+            /// the other way around.
+            /// @returns The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+            T ReadNumber()
+            {
+                auto initial = ReadByte();
+                auto type = static_cast<CborMajorType>(initial >> 5);
+                if (type == CborMajorType::Unsigned)
+                {
+                    return FromUnsigned<T>(ReadArgument(initial));
+                }
+
+                if (type == CborMajorType::Negative)
+                {
+                    auto argument = ReadArgument(initial);
+                    if (argument > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                    {
+                        if constexpr (std::is_floating_point_v<T>)
+                        {
+                            return static_cast<T>(-1.0 - static_cast<double>(argument));
+                        }
+                        else
+                        {
+                            ThrowOutOfRange();
+                        }
+                    }
+
+                    return FromSigned<T>(-1 - static_cast<int64_t>(argument));
+                }
+
+                if (type == CborMajorType::Simple && initial >= 0xf9 && initial <= 0xfb)
+                {
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        switch (initial)
+                        {
+                            case 0xf9: return static_cast<T>(HalfToDouble(ReadBigEndian<uint16_t>()));
+                            case 0xfa: return static_cast<T>(ReadBigEndian<float>());
+                            default: return static_cast<T>(ReadBigEndian<double>());
+                        }
+                    }
+                }
+
+                ThrowUnexpected(std::is_floating_point_v<T> ? "a number" : "an integer");
+            }
+
+            /// Reads a text string.
+            /// @returns The characters, which remain in the buffer.
+            std::string_view ReadString()
+            {
+                auto size = ReadHeader(CborMajorType::TextString, "a text string");
+                return std::string_view(ReadBytes(size), size);
+            }
+
+            /// Reads a byte string.
+            /// @returns The bytes, which remain in the buffer.
+            std::string_view ReadByteString()
+            {
+                auto size = ReadHeader(CborMajorType::ByteString, "a byte string");
+                return std::string_view(ReadBytes(size), size);
+            }
+
+            /// Reads the header of an array.
+            /// @returns The number of elements that follow.
+            std::size_t ReadArrayHeader()
+            {
+                return ReadHeader(CborMajorType::Array, "an array");
+            }
+
+            /// Reads the header of a map.
+            /// @returns The number of key value pairs that follow.
+            std::size_t ReadMapHeader()
+            {
+                return ReadHeader(CborMajorType::Map, "a map");
+            }
+
+            /// Reads a tag, which is followed by the data item it tags.
+            /// @returns The tag number.
+            uint64_t ReadTag()
+            {
+                auto initial = ReadByte();
+                if (static_cast<CborMajorType>(initial >> 5) != CborMajorType::Tag)
+                {
+                    ThrowUnexpected("a tag");
+                }
+
+                return ReadArgument(initial);
+            }
+
+            /// Skips over the next data item, including everything nested in it.
+            void Skip()
+            {
+                // The number of items left to skip, rather than recursion, so
+                // that deeply nested input cannot overflow the stack.
+                std::size_t pending = 1;
+                while (pending-- != 0)
+                {
+                    auto initial = ReadByte();
+                    auto argument = ReadArgument(initial);
+                    switch (static_cast<CborMajorType>(initial >> 5))
+                    {
+                        case CborMajorType::ByteString:
+                        case CborMajorType::TextString:
+                            ReadBytes(argument);
+                            break;
+                        case CborMajorType::Array:
+                        case CborMajorType::Map:
+                        {
+                            auto children = static_cast<CborMajorType>(initial >> 5) == CborMajorType::Map ? argument * 2 : argument;
+                            if (argument > Remaining() || children > Remaining())
+                            {
+                                ThrowEndOfData();
+                            }
+
+                            pending += static_cast<std::size_t>(children);
+                            break;
+                        }
+                        case CborMajorType::Tag:
+                            ++pending;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            /// Reads raw bytes.
+            /// @param size The number of bytes.
+            /// @returns The bytes, which remain in the buffer.
+            char const* ReadBytes(std::size_t size)
+            {
+                if (size > Remaining())
+                {
+                    ThrowEndOfData();
+                }
+
+                auto bytes = _position;
+                _position += size;
+                return bytes;
+            }
+
+            /// Gets the number of bytes left to read.
+            /// @returns The number of bytes.
+            std::size_t Remaining() const
+            {
+                return static_cast<std::size_t>(_end - _position);
+            }
+
+            /// Starts reading the properties of an object.
+            /// @returns Whether or not all of its properties must be present.
+            /// @remarks Properties of nested objects are always required.
+            bool EnterObject()
+            {
+                auto required = _propertiesRequired || _depth != 0;
+                ++_depth;
+                return required;
+            }
+
+            /// Finishes reading the properties of an object.
+            void ExitObject()
+            {
+                --_depth;
+            }
+
+        private:
+            char const* _position;
+            char const* _end;
+            bool _propertiesRequired;
+            std::size_t _depth = 0;
+
+            unsigned char ReadByte()
+            {
+                return static_cast<unsigned char>(*ReadBytes(1));
+            }
+
+            template <typename T>
+            T ReadBigEndian()
+            {
+                T value;
+                std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+                return NativeToBigEndian(value);
+            }
+
+            /// Reads the argument that follows an initial byte. For simple
+            /// values and floats, this is the value's own encoding.
+            uint64_t ReadArgument(unsigned char initial)
+            {
+                auto info = initial & 0x1f;
+                switch (info)
+                {
+                    case 24: return ReadBigEndian<uint8_t>();
+                    case 25: return ReadBigEndian<uint16_t>();
+                    case 26: return ReadBigEndian<uint32_t>();
+                    case 27: return ReadBigEndian<uint64_t>();
+                    case 28:
+                    case 29:
+                    case 30:
+                        throw OpCoSerializerException("Invalid CBOR data item during deserialization");
+                    case 31:
+                        throw OpCoSerializerException("Indefinite length CBOR items are not supported during deserialization");
+                    default:
+                        return static_cast<uint64_t>(info);
+                }
+            }
+
+            std::size_t ReadHeader(CborMajorType type, char const* expected)
+            {
+                auto initial = ReadByte();
+                if (static_cast<CborMajorType>(initial >> 5) != type)
+                {
+                    ThrowUnexpected(expected);
+                }
+
+                auto argument = ReadArgument(initial);
+                if (argument > Remaining())
+                {
+                    ThrowEndOfData();
+                }
+
+                return static_cast<std::size_t>(argument);
+            }
+
+            /// Decodes a half precision float, as in RFC 8949 appendix D.
+            static double HalfToDouble(uint16_t half)
+            {
+                auto exponent = (half >> 10) & 0x1f;
+                auto mantissa = half & 0x3ff;
+                double value;
+                if (exponent == 0)
+                {
+                    value = std::ldexp(mantissa, -24);
+                }
+                else if (exponent != 31)
+                {
+                    value = std::ldexp(mantissa + 1024, exponent - 25);
+                }
+                else
+                {
+                    value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+                }
+
+                return (half & 0x8000) != 0 ? -value : value;
+            }
+
+            template <typename T>
+            static T FromUnsigned(uint64_t value)
+            {
+                if constexpr (std::is_integral_v<T>)
+                {
+                    if (value > static_cast<uint64_t>(std::numeric_limits<T>::max()))
+                    {
+                        ThrowOutOfRange();
+                    }
+                }
+
+                return static_cast<T>(value);
+            }
+
+            template <typename T>
+            static T FromSigned(int64_t value)
+            {
+                if constexpr (std::is_integral_v<T>)
+                {
+                    if constexpr (std::is_unsigned_v<T>)
+                    {
+                        ThrowOutOfRange();
+                    }
+                    else if (value < static_cast<int64_t>(std::numeric_limits<T>::min()))
+                    {
+                        ThrowOutOfRange();
+                    }
+                }
+
+                return static_cast<T>(value);
+            }
+
+            [[noreturn]] static void ThrowOutOfRange()
+            {
+                throw OpCoSerializerException("Integer out of range during deserialization");
+            }
+
+            [[noreturn]] static void ThrowEndOfData()
+            {
+                throw OpCoSerializerException("Unexpected end of CBOR data during deserialization");
+            }
+
+            [[noreturn]] static void ThrowUnexpected(char const* expected)
+            {
+                throw OpCoSerializerException(std::string("Unexpected CBOR data item during deserialization - expected ") + expected);
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_CBOR_STREAMS_HPP
@@ -0,0 +1,400 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_CBOR_TYPE_SERIALIZER_HPP
+#define OPCOSERIALIZER_CBOR_TYPE_SERIALIZER_HPP
+
+#include <bit>
+#include <bitset>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Cbor/CborStreams.hpp"
+
+namespace OpCoSerializer::Cbor
+{
+    template <typename T>
+    struct CborTypeSerializer;
+
+    /// Checks whether or not vectors of T are written as RFC 8746 typed
+    /// arrays, i.e. T is a number other than bool.
+    /// @tparam T The element type.
+    template <typename T>
+    bool constexpr IsCborTypedArrayElementV = std::is_arithmetic_v<T>
+        && !std::is_same_v<T, bool>
+        && (std::is_integral_v<T> || sizeof(T) == 4 || sizeof(T) == 8);
+
+    /// Gets the RFC 8746 tag of a typed array of T with the given byte order.
+    /// @remarks The tag's bits are 010fsell: whether the elements are floating
+    /// point, signed, little endian, and the log2 of their size (minus one
+    /// for floating point, which starts at half precision). Single bytes have
+    /// no byte order, and always use the big endian tag.
+    /// @tparam T The element type.
+    /// @param order The byte order of the elements.
+    /// @returns The tag number.
+    template <typename T>
+        requires IsCborTypedArrayElementV<T>
+    constexpr uint64_t CborTypedArrayTag(std::endian order) noexcept
+    {
+        uint64_t tag = 0x40;
+        if (order == std::endian::little && sizeof(T) > 1)
+        {
+            tag |= 0x04;
+        }
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return tag | 0x10 | (std::bit_width(sizeof(T)) - 2);
+        }
+        else
+        {
+            return tag | (std::is_signed_v<T> ? 0x08 : 0x00) | (std::bit_width(sizeof(T)) - 1);
+        }
+    }
+
+    /// Writes the CBOR encoding of the given value.
+    /// @tparam T The type of the value.
+    /// @param writer The writer.
+    /// @param value The value.
+    template <typename T>
+    void WriteCbor(CborWriter& writer, T const& value)
+    {
+        CborTypeSerializer<T>::Write(writer, value);
+    }
+
+    /// Reads a value into an existing instance, reusing its storage.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @param value The value to read into.
+    template <typename T>
+    void ReadCbor(CborReader& reader, T& value)
+    {
+        CborTypeSerializer<T>::Read(reader, value);
+    }
+
+    /// Reads a new value.
+    /// @remarks Types without a default constructor are constructed from the
+    /// values of their properties, otherwise a value initialized instance is
+    /// read into.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @returns The value.
+    template <typename T>
+    T ReadCborValue(CborReader& reader)
+    {
+        if constexpr (IsConstructedFromPropertiesV<T>)
+        {
+            return CborTypeSerializer<T>::Construct(reader);
+        }
+        else
+        {
+            T value{};
+            ReadCbor(reader, value);
+            return value;
+        }
+    }
+
+    /// Provides CBOR serialization and deserialization logic for a type.
+    /// @remarks Specialize this type in order to be able serialize or
+    /// deserialize any type of data. By default, this type will support:
+    /// - Numeric, boolean and enum types, in the shortest encoding that holds
+    /// the value.
+    /// - Types that have OpCoSerializer properties that are recursively
+    /// serializable, as maps keyed by property name. Unknown keys are skipped
+    /// when reading.
+    /// @tparam T The type.
+    template <typename T>
+    struct CborTypeSerializer
+    {
+        /// Writes the given value.
+        /// @param writer The writer.
+        /// @param value The value.
+        static void Write(CborWriter& writer, T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                writer.WriteMapHeader(PropertyCountV<T>);
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    writer.WriteString(property.name, property.nameLength);
+                    WriteCbor<Type>(writer, value.*(property.member));
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                writer.WriteInteger(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                writer.WriteBool(value);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                writer.WriteFloat(value);
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "CborTypeSerializer must be specialized for this type");
+                writer.WriteInteger(value);
+            }
+        }
+
+        /// Reads a value into an existing instance.
+        /// @param reader The reader.
+        /// @param value The value to read into.
+        static void Read(CborReader& reader, T& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                ReadProperties(reader, [&](std::size_t index) {
+                    ForPropertyAt<T>(index, [&](auto& property) {
+                        ReadCbor(reader, value.*(property.member));
+                    });
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                value = static_cast<T>(reader.ReadNumber<std::underlying_type_t<T>>());
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                value = reader.ReadBool();
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T>, "CborTypeSerializer must be specialized for this type");
+                value = reader.ReadNumber<T>();
+            }
+        }
+
+        /// Reads a value by constructing it once from the values of its
+        /// properties, for types without a default constructor.
+        /// @param reader The reader.
+        /// @returns The value.
+        static T Construct(CborReader& reader)
+        {
+            PropertyValuesT<T> values;
+            auto required = ReadProperties(reader, [&](std::size_t index) {
+                ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                    auto& propertyValue = std::get<i>(values);
+                    using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                    propertyValue.emplace(ReadCborValue<Type>(reader));
+                });
+            });
+
+            return ConstructFromProperties<T>(values, required);
+        }
+
+        private:
+            /// Reads the keys of a map, calling read with the index of each
+            /// property for it to read the value, and skipping unknown keys.
+            /// @returns Whether or not all properties were required.
+            template <typename TRead>
+            static bool ReadProperties(CborReader& reader, TRead&& read)
+            {
+                auto size = reader.ReadMapHeader();
+                auto required = reader.EnterObject();
+                std::bitset<PropertyCountV<T>> seen;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    auto key = reader.ReadString();
+                    auto index = PropertyLookup<T>::Find(key.data(), key.size());
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        reader.Skip();
+                        continue;
+                    }
+
+                    seen.set(index);
+                    read(index);
+                }
+
+                if (required && !seen.all())
+                {
+                    std::size_t index = 0;
+                    ForProperty<T>([&](auto& property) {
+                        if (!seen.test(index++))
+                        {
+                            throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                        }
+                    });
+                }
+
+                reader.ExitObject();
+                return required;
+            }
+    };
+
+    /// Partial CborTypeSerializer specialization for a vector of a given type.
+    /// @remarks Vectors of numbers are written as RFC 8746 typed arrays, i.e. a
+    /// tagged byte string holding the elements in native byte order, which are
+    /// written and read with a single copy. Other vectors are written as
+    /// arrays of their elements. Numbers may also be read from an array.
+    template <typename TElement>
+    struct CborTypeSerializer<std::vector<TElement>>
+    {
+        static void Write(CborWriter& writer, std::vector<TElement> const& value)
+        {
+            if constexpr (IsCborTypedArrayElementV<TElement>)
+            {
+                writer.WriteTag(CborTypedArrayTag<TElement>(std::endian::native));
+                writer.WriteByteString(value.data(), value.size() * sizeof(TElement));
+                return;
+            }
+
+            writer.WriteArrayHeader(value.size());
+            for (auto const& element : value)
+            {
+                WriteCbor<TElement>(writer, element);
+            }
+        }
+
+        /// @remarks Existing elements are read into in place, reusing their
+        /// storage, and any left over are removed.
+        static void Read(CborReader& reader, std::vector<TElement>& value)
+        {
+            if constexpr (IsCborTypedArrayElementV<TElement>)
+            {
+                if (reader.PeekMajorType() == CborMajorType::Tag)
+                {
+                    ReadTypedArray(reader, value);
+                    return;
+                }
+            }
+
+            // Every element takes at least one byte, so a corrupt size cannot
+            // reserve huge amounts of memory.
+            auto size = reader.ReadArrayHeader();
+
+            if constexpr (IsConstructedFromPropertiesV<TElement>)
+            {
+                value.clear();
+            }
+
+            while (value.size() > size)
+            {
+                value.pop_back();
+            }
+
+            value.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if constexpr (std::is_same_v<TElement, bool>)
+                {
+                    auto element = reader.ReadBool();
+                    if (i < value.size())
+                    {
+                        value[i] = element;
+                    }
+                    else
+                    {
+                        value.push_back(element);
+                    }
+                }
+                else if constexpr (IsConstructedFromPropertiesV<TElement>)
+                {
+                    value.push_back(ReadCborValue<TElement>(reader));
+                }
+                else if (i < value.size())
+                {
+                    ReadCbor(reader, value[i]);
+                }
+                else
+                {
+                    ReadCbor(reader, value.emplace_back());
+                }
+            }
+        }
+
+        private:
+            /// Reads a typed array of exactly TElement, in either byte order.
+            static void ReadTypedArray(CborReader& reader, std::vector<TElement>& value)
+            {
+                auto constexpr native = CborTypedArrayTag<TElement>(std::endian::native);
+                auto constexpr swapped = CborTypedArrayTag<TElement>(
+                    std::endian::native == std::endian::little ? std::endian::big : std::endian::little);
+
+                auto tag = reader.ReadTag();
+                if (tag != native && tag != swapped)
+                {
+                    throw OpCoSerializerException("Unexpected CBOR typed array during deserialization");
+                }
+
+                auto bytes = reader.ReadByteString();
+                if (bytes.size() % sizeof(TElement) != 0)
+                {
+                    throw OpCoSerializerException("Invalid CBOR typed array length during deserialization");
+                }
+
+                auto size = bytes.size() / sizeof(TElement);
+                value.resize(size);
+                if (size != 0)
+                {
+                    std::memcpy(value.data(), bytes.data(), bytes.size());
+                }
+
+                if (tag != native && sizeof(TElement) > 1)
+                {
+                    for (auto& element : value)
+                    {
+                        element = ByteSwap(element);
+                    }
+                }
+            }
+    };
+
+    /// CborTypeSerializer specialization for a C++ string.
+    template <>
+    struct CborTypeSerializer<std::string>
+    {
+        static void Write(CborWriter& writer, std::string const& value)
+        {
+            writer.WriteString(value.data(), value.size());
+        }
+
+        static void Read(CborReader& reader, std::string& value)
+        {
+            auto characters = reader.ReadString();
+            value.assign(characters.data(), characters.size());
+        }
+    };
+
+    /// CborTypeSerializer specialization for a C++ string view.
+    /// @remarks Deserialized views refer to the characters in the buffer being
+    /// deserialized, so the buffer must outlive them.
+    template <>
+    struct CborTypeSerializer<std::string_view>
+    {
+        static void Write(CborWriter& writer, std::string_view const& value)
+        {
+            writer.WriteString(value.data(), value.size());
+        }
+
+        static void Read(CborReader& reader, std::string_view& value)
+        {
+            value = reader.ReadString();
+        }
+    };
+}
+
+#endif // OPCOSERIALIZER_CBOR_TYPE_SERIALIZER_HPP
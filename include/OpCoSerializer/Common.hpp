@@ -22,7 +22,14 @@
 #define OPCOSERIALIZER_COMMON_HPP
 
 // Standard library includes
+#include <array>
+#include <bit>
+#include <bitset>
 #include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <tuple>
 #include <type_traits>
@@ -83,12 +90,23 @@ namespace OpCoSerializer
         /// The propery name.
         char const* name;
 
+        /// The length of the property name.
+        std::size_t nameLength;
+
+        /// The field number used by encodings that identify properties by
+        /// number rather than name, or zero to use the property's index plus one.
+        uint32_t fieldNumber;
+
         /// Initializes a new instance of the Property type.
         /// @param member The member pointer.
         /// @param name The property name.
-        constexpr Property(T Class::* member, char const* name)
+        /// @param fieldNumber The field number, or zero to use the property's
+        /// index plus one.
+        constexpr Property(T Class::* member, char const* name, uint32_t fieldNumber = 0)
             : member{member},
-              name{name}
+              name{name},
+              nameLength{std::char_traits<char>::length(name)},
+              fieldNumber{fieldNumber}
         {
         }
     };
@@ -103,6 +121,21 @@ namespace OpCoSerializer
         return Property<Class, T>{member, name};
     }
 
+    /// Creates a property for the given member with a given name and field
+    /// number, e.g. for the tagged encoding.
+    /// @remarks Field numbers must be unique within a type and should never
+    /// be reused, so that messages stay compatible as properties are added
+    /// and removed.
+    /// @param member The member pointer.
+    /// @param name The property name.
+    /// @param fieldNumber The field number, from 1.
+    /// @returns The created property.
+    template<typename Class, typename T>
+    constexpr auto MakeProperty(T Class::* member, const char* name, uint32_t fieldNumber)
+    {
+        return Property<Class, T>{member, name, fieldNumber};
+    }
+
     /// Forwards to MakeProperty, assuming the member name and serialization name
     /// are the same.
     #define OPCOSERIALIZER_PROPERTY(CLASS, MEMBER) OpCoSerializer::MakeProperty(&CLASS::MEMBER, #MEMBER)
@@ -126,6 +159,549 @@ namespace OpCoSerializer
             f(property);
         });
     }
+
+    /// The number of serializable properties of T.
+    template <typename T>
+    std::size_t constexpr PropertyCountV = std::tuple_size<decltype(T::SerializerProperties())>::value;
+
+    /// Finds the index of the serializable property of T for the given member.
+    /// @tparam T The type with the properties.
+    /// @tparam Member The member pointer, e.g. &T::member.
+    template <typename T, auto Member>
+    class PropertyIndexOf final
+    {
+        private:
+            static constexpr std::size_t Find()
+            {
+                std::size_t found = PropertyCountV<T>;
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    if constexpr (std::is_same_v<decltype(property.member), decltype(Member)>)
+                    {
+                        if (property.member == Member)
+                        {
+                            found = index;
+                        }
+                    }
+
+                    ++index;
+                });
+
+                return found;
+            }
+
+        public:
+            static constexpr std::size_t value = Find();
+
+            static_assert(value < PropertyCountV<T>, "The member is not a serializable property of T");
+    };
+
+    /// Helper for the value of PropertyIndexOf<T, Member>.
+    template <typename T, auto Member>
+    std::size_t constexpr PropertyIndexOfV = PropertyIndexOf<T, Member>::value;
+
+    /// Applies the function f to the integral constant for the given index.
+    /// @remarks This dispatches through a table, so the cost does not depend
+    /// on the number of indices.
+    /// @tparam N The number of indices.
+    /// @param index The index. Must be less than N.
+    /// @param f The function.
+    template <std::size_t N, typename F>
+    constexpr inline void ForIndexAt(std::size_t index, F&& f)
+    {
+        using Function = std::remove_reference_t<F>;
+        auto constexpr table = []<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<void (*)(Function&), sizeof...(I)>{
+                [](Function& function) {
+                    function(std::integral_constant<std::size_t, I>{});
+                }...
+            };
+        }(std::make_index_sequence<N>{});
+
+        table[index](f);
+    }
+
+    /// Applies the function f to the serializable property of T at the given index.
+    /// @remarks This dispatches through a table, so the cost does not depend
+    /// on the number of properties.
+    /// @param index The property index. Must be less than PropertyCountV<T>.
+    /// @param f The function.
+    template <typename T, typename F>
+    constexpr inline void ForPropertyAt(std::size_t index, F&& f)
+    {
+        ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+            auto constexpr property = std::get<i>(T::SerializerProperties());
+            f(property);
+        });
+    }
+
+    /// Holds the values of T's serializable properties whilst they are
+    /// deserialized, before T is constructed from them.
+    template <typename T, typename TProperties = decltype(T::SerializerProperties())>
+    struct PropertyValues;
+
+    template <typename T, typename... TProperties>
+    struct PropertyValues<T, std::tuple<TProperties...>>
+    {
+        using type = std::tuple<std::optional<std::remove_cvref_t<typename TProperties::Type>>...>;
+    };
+
+    /// Helper for the type of PropertyValues<T>.
+    template <typename T>
+    using PropertyValuesT = typename PropertyValues<T>::type;
+
+    /// Whether or not T is deserialized by constructing it from the values of
+    /// its properties, rather than reading them into a default instance.
+    template <typename T>
+    bool constexpr IsConstructedFromPropertiesV = HasSerializablePropertiesV<T> && !std::is_default_constructible_v<T>;
+
+    /// Constructs T once from the deserialized values of its properties,
+    /// moving each value in.
+    /// @remarks Aggregates are initialized with the values in property order.
+    /// Otherwise T must have a constructor taking the values in property order.
+    /// A missing value is value initialized if possible and properties are not
+    /// required, otherwise an exception is thrown.
+    /// @param values The property values.
+    /// @param required Whether or not all properties must be present.
+    /// @returns The constructed value.
+    template <typename T>
+    T ConstructFromProperties(PropertyValuesT<T>& values, bool required)
+    {
+        auto take = [&](auto i) -> decltype(auto) {
+            auto& value = std::get<i>(values);
+            using Type = typename std::remove_cvref_t<decltype(value)>::value_type;
+            if constexpr (std::is_default_constructible_v<Type>)
+            {
+                if (!value && !required)
+                {
+                    value.emplace();
+                }
+            }
+
+            if (!value)
+            {
+                throw OpCoSerializerException(std::string("Missing property during deserialization - ") + std::get<i>(T::SerializerProperties()).name);
+            }
+
+            return std::move(*value);
+        };
+
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            if constexpr (std::is_aggregate_v<T>)
+            {
+                return T{ take(std::integral_constant<std::size_t, I>{})... };
+            }
+            else
+            {
+                static_assert(
+                    std::is_constructible_v<T, typename std::tuple_element_t<I, PropertyValuesT<T>>::value_type&&...>,
+                    "T must be an aggregate or have a constructor taking its properties in order");
+                return T(take(std::integral_constant<std::size_t, I>{})...);
+            }
+        }(std::make_index_sequence<PropertyCountV<T>>{});
+    }
+
+    /// A vector of values with serializable properties which is serialized as
+    /// columns rather than rows: one array per property, holding the value of
+    /// that property for every element in order.
+    /// @remarks This is otherwise a std::vector<T>, so it can replace one as
+    /// the type of a property in order to change its encoding. Repeated names
+    /// are written once and each column holds values of a single type, e.g. so
+    /// that numeric columns are written in bulk. Supported by the JSON and
+    /// binary serializers.
+    /// @tparam T The type of the elements. Must be default constructible.
+    template <typename T>
+    struct Columnar final : std::vector<T>
+    {
+        static_assert(HasSerializablePropertiesV<T>, "Columnar elements must have serializable properties");
+        static_assert(std::is_default_constructible_v<T>, "Columnar elements must be default constructible");
+
+        using std::vector<T>::vector;
+
+        Columnar() = default;
+
+        /// Initializes a new instance of the Columnar type.
+        /// @param rows The elements.
+        Columnar(std::vector<T> rows)
+            : std::vector<T>(std::move(rows))
+        {
+        }
+    };
+
+    /// Checks whether or not T is a std::vector.
+    template <typename T>
+    struct IsVector : std::false_type
+    {
+    };
+
+    template <typename TElement>
+    struct IsVector<std::vector<TElement>> : std::true_type
+    {
+    };
+
+    /// Helper for the value of IsVector<T>.
+    template <typename T>
+    bool constexpr IsVectorV = IsVector<T>::value;
+
+    /// Checks whether or not T holds a sequence of elements which serialize
+    /// one by one, i.e. a std::vector, Columnar or std::array.
+    template <typename T>
+    struct IsSequence : IsVector<T>
+    {
+    };
+
+    template <typename TElement>
+    struct IsSequence<Columnar<TElement>> : std::true_type
+    {
+    };
+
+    template <typename TElement, std::size_t N>
+    struct IsSequence<std::array<TElement, N>> : std::true_type
+    {
+    };
+
+    /// Helper for the value of IsSequence<T>.
+    template <typename T>
+    bool constexpr IsSequenceV = IsSequence<T>::value;
+
+    /// Checks whether or not two values serialize the same, comparing their
+    /// properties and the elements of vectors, Columnar and arrays
+    /// recursively.
+    /// @remarks Floating point values are compared by their bits, so a change
+    /// of sign of zero counts as a change and an unchanged NaN does not. Other
+    /// values are compared with operator== where they have one, otherwise they
+    /// are never considered equal.
+    /// @param first The first value.
+    /// @param second The second value.
+    /// @returns Whether or not the values are equal.
+    template <typename T>
+    bool SerializedEqual(T const& first, T const& second)
+    {
+        if constexpr (HasSerializablePropertiesV<T>)
+        {
+            bool equal = true;
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                equal = equal && SerializedEqual<Type>(first.*(property.member), second.*(property.member));
+            });
+
+            return equal;
+        }
+        else if constexpr (IsSequenceV<T>)
+        {
+            if (first.size() != second.size())
+            {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < first.size(); ++i)
+            {
+                if (!SerializedEqual<typename T::value_type>(first[i], second[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            using Bits = std::array<unsigned char, sizeof(T)>;
+            return std::bit_cast<Bits>(first) == std::bit_cast<Bits>(second);
+        }
+        else if constexpr (std::equality_comparable<T>)
+        {
+            return first == second;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /// Checks whether or not the serializable properties of T make up its
+    /// entire object representation, in property order and without padding,
+    /// so that writing the properties in order produces the bytes of T.
+    /// @remarks T must be trivially copyable and constant evaluable when
+    /// value initialized, otherwise this is false.
+    /// @tparam T The type to check.
+    template <typename T>
+    class PropertiesMatchLayout final
+    {
+        private:
+            // The properties tile the object representation in order when
+            // their sizes add up to the size of T and each starts after the
+            // one before, as they cannot overlap.
+            static constexpr bool Tile()
+            {
+                T value{};
+                std::size_t size = 0;
+                void const* previous = nullptr;
+                bool ordered = true;
+                ForProperty<T>([&](auto& property) {
+                    auto address = static_cast<void const*>(&(value.*(property.member)));
+                    ordered = ordered && (previous == nullptr || previous < address);
+                    previous = address;
+                    size += sizeof(value.*(property.member));
+                });
+
+                return ordered && size == sizeof(T);
+            }
+
+            static constexpr bool Check()
+            {
+                if constexpr (HasSerializablePropertiesV<T> && std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>)
+                {
+                    if constexpr (requires { typename std::bool_constant<Tile()>; })
+                    {
+                        return Tile();
+                    }
+                }
+
+                return false;
+            }
+
+        public:
+            static constexpr bool value = Check();
+    };
+
+    /// Helper for the value of PropertiesMatchLayout<T>.
+    template <typename T>
+    bool constexpr PropertiesMatchLayoutV = PropertiesMatchLayout<T>::value;
+
+    /// Maps the names of T's serializable properties to their indices.
+    /// @remarks A perfect hash is generated at compile time from
+    /// T::SerializerProperties(), so a lookup hashes the name once, probes a
+    /// single slot and compares a single name.
+    /// @tparam T The type with serializable properties.
+    template <typename T>
+    class PropertyLookup final
+    {
+        public:
+            /// The index returned for names that are not properties of T.
+            static std::size_t constexpr npos = std::numeric_limits<std::size_t>::max();
+
+            /// Finds the index of the property with the given name.
+            /// @param name The name. Does not need to be null terminated.
+            /// @param length The length of the name.
+            /// @returns The property index, or npos if there is no such property.
+            static constexpr std::size_t Find(char const* name, std::size_t length) noexcept
+            {
+                auto hash = Hash(name, length);
+                auto const& entry = table.entries[Mix(hash, table.seeds[Mix(hash, 0) & (bucketCount - 1)]) & (slotCount - 1)];
+                return entry.hash == hash
+                        && entry.length == length
+                        && std::char_traits<char>::compare(entry.name, name, length) == 0
+                    ? entry.index
+                    : npos;
+            }
+
+        private:
+            static std::size_t constexpr count = PropertyCountV<T>;
+            static std::size_t constexpr slotCount = std::bit_ceil(count * 2 + 1);
+            static std::size_t constexpr bucketCount = std::bit_ceil(count / 2 + 1);
+
+            struct Entry final
+            {
+                uint64_t hash = 0;
+                char const* name = "";
+                std::size_t length = 0;
+                std::size_t index = npos;
+            };
+
+            struct Table final
+            {
+                std::array<uint64_t, bucketCount> seeds{};
+                std::array<Entry, slotCount> entries{};
+            };
+
+            static constexpr uint64_t Hash(char const* name, std::size_t length) noexcept
+            {
+                uint64_t hash = 14695981039346656037ull;
+                for (std::size_t i = 0; i < length; ++i)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(name[i])) * 1099511628211ull;
+                }
+
+                return hash;
+            }
+
+            static constexpr uint64_t Mix(uint64_t hash, uint64_t seed) noexcept
+            {
+                hash ^= seed * 0x9E3779B97F4A7C15ull;
+                hash = (hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ull;
+                return hash ^ (hash >> 29);
+            }
+
+            static constexpr std::array<Entry, count> Entries()
+            {
+                std::array<Entry, count> entries{};
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    entries[index] = Entry{ Hash(property.name, property.nameLength), property.name, property.nameLength, index };
+                    ++index;
+                });
+
+                return entries;
+            }
+
+            static constexpr bool HasUniqueNames()
+            {
+                auto entries = Entries();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t j = i + 1; j < count; ++j)
+                    {
+                        if (entries[i].length == entries[j].length
+                            && std::char_traits<char>::compare(entries[i].name, entries[j].name, entries[i].length) == 0)
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            // Hash and displace: names are first split into buckets, then
+            // the largest buckets are placed first by searching for a seed
+            // which moves all of the bucket's names into free slots.
+            static constexpr Table Build()
+            {
+                static_assert(HasUniqueNames(), "Serializable property names must be unique");
+
+                Table table{};
+                if (!HasUniqueNames())
+                {
+                    return table;
+                }
+
+                auto entries = Entries();
+
+                std::array<std::size_t, bucketCount> bucketSizes{};
+                for (auto const& entry : entries)
+                {
+                    ++bucketSizes[Mix(entry.hash, 0) & (bucketCount - 1)];
+                }
+
+                std::array<bool, slotCount> occupied{};
+                std::array<bool, bucketCount> placed{};
+                for (std::size_t n = 0; n < bucketCount; ++n)
+                {
+                    std::size_t bucket = 0;
+                    for (std::size_t b = 1; b < bucketCount; ++b)
+                    {
+                        if (!placed[b] && (placed[bucket] || bucketSizes[b] > bucketSizes[bucket]))
+                        {
+                            bucket = b;
+                        }
+                    }
+
+                    placed[bucket] = true;
+                    if (bucketSizes[bucket] == 0)
+                    {
+                        continue;
+                    }
+
+                    for (uint64_t seed = 1; ; ++seed)
+                    {
+                        if (seed > 1000000)
+                        {
+                            throw OpCoSerializerException("Unable to generate a property lookup table");
+                        }
+
+                        auto candidate = occupied;
+                        bool fits = true;
+                        for (auto const& entry : entries)
+                        {
+                            if ((Mix(entry.hash, 0) & (bucketCount - 1)) != bucket)
+                            {
+                                continue;
+                            }
+
+                            auto slot = Mix(entry.hash, seed) & (slotCount - 1);
+                            if (candidate[slot])
+                            {
+                                fits = false;
+                                break;
+                            }
+
+                            candidate[slot] = true;
+                        }
+
+                        if (fits)
+                        {
+                            occupied = candidate;
+                            table.seeds[bucket] = seed;
+                            for (auto const& entry : entries)
+                            {
+                                if ((Mix(entry.hash, 0) & (bucketCount - 1)) == bucket)
+                                {
+                                    table.entries[Mix(entry.hash, seed) & (slotCount - 1)] = entry;
+                                }
+                            }
+
+                            break;
+                        }
+                    }
+                }
+
+                return table;
+            }
+
+            static Table constexpr table = Build();
+    };
+
+    /// Reverses the order of the bytes of an integer or floating point value.
+    /// @param value The value.
+    /// @returns The value with its bytes reversed.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    constexpr T ByteSwap(T value) noexcept
+    {
+        auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+        for (std::size_t i = 0; i < sizeof(T) / 2; ++i)
+        {
+            std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+        }
+
+        return std::bit_cast<T>(bytes);
+    }
+
+    /// Converts a value between native and little endian byte order.
+    /// @param value The value.
+    /// @returns The converted value.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    constexpr T NativeToLittleEndian(T value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1)
+        {
+            return value;
+        }
+        else
+        {
+            return ByteSwap(value);
+        }
+    }
+
+    /// Converts a value between native and big endian byte order.
+    /// @param value The value.
+    /// @returns The converted value.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    constexpr T NativeToBigEndian(T value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::big || sizeof(T) == 1)
+        {
+            return value;
+        }
+        else
+        {
+            return ByteSwap(value);
+        }
+    }
 }
 
 #endif // OPCOSERIALIZER_COMMON_HPP
@@ -0,0 +1,109 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_FLAT_FORMAT_HPP
+#define OPCOSERIALIZER_FLAT_FORMAT_HPP
+
+#include <cstring>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+
+/// The flat format is laid out so that values can be read in place, without
+/// parsing, e.g. from a memory mapped file:
+/// - The buffer starts with the offset of the root table.
+/// - A table is the number of fields, followed by the offset of each field's
+/// value in property order. Fields beyond the number written read as their
+/// default value, so properties can be added to the end of a type.
+/// - Numbers are stored in little endian byte order, aligned to their size.
+/// Booleans are stored as a byte and enums as their underlying type.
+/// - A string is its length, followed by its characters and a null terminator.
+/// - A vector of numbers is its size, four bytes of padding and its elements.
+/// Other vectors are their size, followed by the offset of each element.
+/// Offsets, lengths and sizes are 32 bit, and offsets are from the start of
+/// the buffer. Tables and vectors are aligned to 8 bytes.
+namespace OpCoSerializer::Flat
+{
+    /// An offset from the start of a flat buffer.
+    using FlatOffset = uint32_t;
+
+    /// The alignment of tables and vectors, which is enough for any number.
+    std::size_t constexpr FlatAlignment = 8;
+
+    /// Checks whether or not T is a number, boolean or enum, which are
+    /// stored in place rather than through an offset.
+    /// @tparam T The type to check.
+    template <typename T>
+    bool constexpr IsFlatScalarV = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    /// The type a number, boolean or enum is stored as.
+    /// @tparam T The type of the value.
+    template <typename T>
+    struct FlatStorage
+    {
+        using type = T;
+    };
+
+    template <>
+    struct FlatStorage<bool>
+    {
+        using type = uint8_t;
+    };
+
+    template <typename T>
+        requires std::is_enum_v<T>
+    struct FlatStorage<T>
+    {
+        using type = std::underlying_type_t<T>;
+    };
+
+    /// Helper for the type of FlatStorage<T>.
+    template <typename T>
+    using FlatStorageT = typename FlatStorage<T>::type;
+
+    /// Checks that a range lies within a flat buffer.
+    /// @param buffer The buffer.
+    /// @param offset The start of the range.
+    /// @param size The size of the range.
+    inline void CheckFlatRange(std::string_view buffer, std::size_t offset, std::size_t size)
+    {
+        if (offset > buffer.size() || size > buffer.size() - offset)
+        {
+            throw OpCoSerializerException("Offset out of range of the flat buffer");
+        }
+    }
+
+    /// Loads a number from a flat buffer.
+    /// @remarks The number is copied out, so need not be aligned.
+    /// @tparam T The type of the number.
+    /// @param buffer The buffer.
+    /// @param offset The offset of the number.
+    /// @returns The number.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    T LoadFlat(std::string_view buffer, std::size_t offset)
+    {
+        CheckFlatRange(buffer, offset, sizeof(T));
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        return NativeToLittleEndian(value);
+    }
+}
+
+#endif // OPCOSERIALIZER_FLAT_FORMAT_HPP
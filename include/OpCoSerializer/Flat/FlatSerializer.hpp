@@ -0,0 +1,179 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_FLAT_SERIALIZER_HPP
+#define OPCOSERIALIZER_FLAT_SERIALIZER_HPP
+
+#include <bit>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Flat/FlatFormat.hpp"
+
+namespace OpCoSerializer::Flat
+{
+    /// Serializes objects to the flat format, which is read in place through
+    /// a FlatView rather than deserialized.
+    /// @remarks The supported types are numbers, booleans, enums, strings,
+    /// string views, vectors, and types with OpCoSerializer properties. The
+    /// outermost value must have properties. See FlatFormat.hpp for the layout.
+    class FlatSerializer final
+    {
+        public:
+            /// Serializes the given value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @returns The serialized bytes.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            std::string Serialize(T const& value)
+            {
+                std::string serialized;
+                Serialize(value, serialized);
+                return serialized;
+            }
+
+            /// Serializes the given value into an existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                serialized.clear();
+                AppendScalar(serialized, FlatOffset{0});
+                auto root = WriteValue(serialized, value);
+                Patch(serialized, 0, root);
+            }
+
+        private:
+            template <typename T>
+            static FlatOffset WriteValue(std::string& output, T const& value)
+            {
+                if constexpr (HasSerializablePropertiesV<T>)
+                {
+                    Align(output, FlatAlignment);
+                    auto table = output.size();
+                    AppendScalar(output, static_cast<FlatOffset>(PropertyCountV<T>));
+                    output.append(PropertyCountV<T> * sizeof(FlatOffset), '\0');
+
+                    std::size_t index = 0;
+                    ForProperty<T>([&](auto& property) {
+                        auto offset = WriteValue(output, value.*(property.member));
+                        Patch(output, table + sizeof(FlatOffset) * ++index, offset);
+                    });
+
+                    return ToOffset(table);
+                }
+                else
+                {
+                    static_assert(IsFlatScalarV<T>, "The type is not supported by the flat format");
+                    Align(output, sizeof(FlatStorageT<T>));
+                    auto offset = ToOffset(output.size());
+                    AppendScalar(output, value);
+                    return offset;
+                }
+            }
+
+            static FlatOffset WriteValue(std::string& output, std::string_view value)
+            {
+                Align(output, sizeof(FlatOffset));
+                auto offset = ToOffset(output.size());
+                AppendScalar(output, ToOffset(value.size()));
+                output.append(value);
+                output.push_back('\0');
+                return offset;
+            }
+
+            static FlatOffset WriteValue(std::string& output, std::string const& value)
+            {
+                return WriteValue(output, std::string_view(value));
+            }
+
+            template <typename TElement>
+            static FlatOffset WriteValue(std::string& output, std::vector<TElement> const& value)
+            {
+                Align(output, FlatAlignment);
+                auto offset = ToOffset(output.size());
+                AppendScalar(output, ToOffset(value.size()));
+
+                if constexpr (IsFlatScalarV<TElement>)
+                {
+                    AppendScalar(output, uint32_t{0});
+                    if constexpr (std::endian::native == std::endian::little && !std::is_same_v<TElement, bool>)
+                    {
+                        output.append(reinterpret_cast<char const*>(value.data()), value.size() * sizeof(TElement));
+                    }
+                    else
+                    {
+                        for (auto const element : value)
+                        {
+                            AppendScalar(output, element);
+                        }
+                    }
+                }
+                else
+                {
+                    auto elements = output.size();
+                    output.append(value.size() * sizeof(FlatOffset), '\0');
+                    for (std::size_t i = 0; i < value.size(); ++i)
+                    {
+                        Patch(output, elements + i * sizeof(FlatOffset), WriteValue(output, value[i]));
+                    }
+                }
+
+                return offset;
+            }
+
+            template <typename T>
+            static void AppendScalar(std::string& output, T value)
+            {
+                auto stored = NativeToLittleEndian(static_cast<FlatStorageT<T>>(value));
+                output.append(reinterpret_cast<char const*>(&stored), sizeof(stored));
+            }
+
+            static void Patch(std::string& output, std::size_t position, FlatOffset offset)
+            {
+                auto stored = NativeToLittleEndian(offset);
+                std::memcpy(output.data() + position, &stored, sizeof(stored));
+            }
+
+            static void Align(std::string& output, std::size_t alignment)
+            {
+                output.resize((output.size() + alignment - 1) / alignment * alignment, '\0');
+            }
+
+            static FlatOffset ToOffset(std::size_t value)
+            {
+                if (value > std::numeric_limits<FlatOffset>::max())
+                {
+                    throw OpCoSerializerException("Value too large for the flat format during serialization");
+                }
+
+                return static_cast<FlatOffset>(value);
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_FLAT_SERIALIZER_HPP
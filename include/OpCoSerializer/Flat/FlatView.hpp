@@ -0,0 +1,298 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_FLAT_VIEW_HPP
+#define OPCOSERIALIZER_FLAT_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Flat/FlatFormat.hpp"
+
+namespace OpCoSerializer::Flat
+{
+    template <typename T>
+    class FlatView;
+
+    template <typename TElement>
+    class FlatVectorView;
+
+    /// Reads a value of type T in place from a flat buffer.
+    /// @remarks Numbers, booleans and enums are copied out, types with
+    /// properties are read through a FlatView, strings as a std::string_view
+    /// into the buffer, and vectors through a FlatVectorView.
+    /// @tparam T The type of the value as it was serialized.
+    template <typename T>
+    struct FlatValue
+    {
+        /// Reads the value.
+        /// @param buffer The buffer.
+        /// @param offset The offset of the value.
+        /// @returns The value, or a view of it.
+        static auto Load(std::string_view buffer, std::size_t offset)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                return FlatView<T>(buffer, offset);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return LoadFlat<uint8_t>(buffer, offset) != 0;
+            }
+            else
+            {
+                static_assert(IsFlatScalarV<T>, "The type is not supported by the flat format");
+                return static_cast<T>(LoadFlat<FlatStorageT<T>>(buffer, offset));
+            }
+        }
+
+        /// The type a value is read as.
+        using ViewType = decltype(Load(std::string_view(), 0));
+    };
+
+    template <>
+    struct FlatValue<std::string_view>
+    {
+        static std::string_view Load(std::string_view buffer, std::size_t offset)
+        {
+            auto length = LoadFlat<FlatOffset>(buffer, offset);
+            CheckFlatRange(buffer, offset + sizeof(FlatOffset), length);
+            return buffer.substr(offset + sizeof(FlatOffset), length);
+        }
+
+        using ViewType = std::string_view;
+    };
+
+    template <>
+    struct FlatValue<std::string> : FlatValue<std::string_view>
+    {
+    };
+
+    template <typename TElement>
+    struct FlatValue<std::vector<TElement>>
+    {
+        static FlatVectorView<TElement> Load(std::string_view buffer, std::size_t offset)
+        {
+            return FlatVectorView<TElement>(buffer, offset);
+        }
+
+        using ViewType = FlatVectorView<TElement>;
+    };
+
+    /// A read-only view of a value of type T in a flat buffer, as written by a
+    /// FlatSerializer, which reads each property in place when it is asked for.
+    /// @remarks Nothing is parsed or allocated. Every read is bounds checked,
+    /// throwing an OpCoSerializerException rather than reading beyond the end
+    /// of the buffer, so untrusted buffers are safe to view. The buffer, e.g.
+    /// a memory mapped file, must outlive the view and anything read from it.
+    /// @tparam T The type of the value.
+    template <typename T>
+    class FlatView final
+    {
+        public:
+            /// Initializes a new instance of the FlatView type, for a value
+            /// whose properties all have their default values.
+            FlatView() = default;
+
+            /// Initializes a new instance of the FlatView type for the
+            /// outermost value in a buffer.
+            /// @param buffer The buffer.
+            explicit FlatView(std::string_view buffer)
+                : FlatView(buffer, LoadFlat<FlatOffset>(buffer, 0))
+            {
+            }
+
+            /// Initializes a new instance of the FlatView type for the value at
+            /// the given offset.
+            /// @param buffer The buffer.
+            /// @param table The offset of the value's table.
+            FlatView(std::string_view buffer, std::size_t table)
+                : _buffer(buffer),
+                  _table(table),
+                  _count(LoadFlat<FlatOffset>(buffer, table))
+            {
+                CheckFlatRange(buffer, table + sizeof(FlatOffset), _count * sizeof(FlatOffset));
+            }
+
+            /// Reads a property.
+            /// @tparam Member The member pointer of the property, e.g. &T::member.
+            /// @returns The property value, or a view of it. Properties which
+            /// were not written have their default value.
+            template <auto Member>
+            auto Get() const
+            {
+                auto constexpr index = PropertyIndexOfV<T, Member>;
+                using PropertyType = std::remove_cvref_t<decltype(std::get<index>(T::SerializerProperties()))>;
+                using Value = FlatValue<std::remove_cvref_t<typename PropertyType::Type>>;
+
+                if (index >= _count)
+                {
+                    return typename Value::ViewType{};
+                }
+
+                return typename Value::ViewType(Value::Load(_buffer, LoadFlat<FlatOffset>(_buffer, _table + sizeof(FlatOffset) * (index + 1))));
+            }
+
+        private:
+            std::string_view _buffer;
+            std::size_t _table = 0;
+            std::size_t _count = 0;
+    };
+
+    /// A read-only view of a vector in a flat buffer.
+    /// @remarks Elements are read in place in the same way as the properties
+    /// of a FlatView, and indexing is bounds checked.
+    /// @tparam TElement The type of the elements.
+    template <typename TElement>
+    class FlatVectorView final
+    {
+        public:
+            /// The type an element is read as.
+            using ViewType = typename FlatValue<TElement>::ViewType;
+
+            /// Iterates the elements of a FlatVectorView.
+            class Iterator final
+            {
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = ViewType;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = ViewType;
+
+                    Iterator() = default;
+
+                    Iterator(FlatVectorView const* vector, std::size_t index)
+                        : _vector(vector),
+                          _index(index)
+                    {
+                    }
+
+                    ViewType operator*() const
+                    {
+                        return (*_vector)[_index];
+                    }
+
+                    Iterator& operator++()
+                    {
+                        ++_index;
+                        return *this;
+                    }
+
+                    Iterator operator++(int)
+                    {
+                        auto previous = *this;
+                        ++_index;
+                        return previous;
+                    }
+
+                    bool operator==(Iterator const& other) const
+                    {
+                        return _index == other._index;
+                    }
+
+                private:
+                    FlatVectorView const* _vector = nullptr;
+                    std::size_t _index = 0;
+            };
+
+            /// Initializes a new instance of the FlatVectorView type for an
+            /// empty vector.
+            FlatVectorView() = default;
+
+            /// Initializes a new instance of the FlatVectorView type for the
+            /// vector at the given offset.
+            /// @param buffer The buffer.
+            /// @param offset The offset of the vector.
+            FlatVectorView(std::string_view buffer, std::size_t offset)
+                : _buffer(buffer),
+                  _size(LoadFlat<FlatOffset>(buffer, offset)),
+                  _elements(offset + (IsFlatScalarV<TElement> ? 2 * sizeof(FlatOffset) : sizeof(FlatOffset)))
+            {
+                CheckFlatRange(buffer, _elements, _size * ElementSize);
+            }
+
+            /// Gets the number of elements.
+            /// @returns The number of elements.
+            std::size_t Size() const
+            {
+                return _size;
+            }
+
+            /// Checks whether or not there are no elements.
+            /// @returns True if there are no elements.
+            bool Empty() const
+            {
+                return _size == 0;
+            }
+
+            /// Reads an element.
+            /// @param index The index of the element.
+            /// @returns The element, or a view of it.
+            ViewType operator[](std::size_t index) const
+            {
+                if (index >= _size)
+                {
+                    throw OpCoSerializerException("Index out of range of the flat vector");
+                }
+
+                auto position = _elements + index * ElementSize;
+                if constexpr (IsFlatScalarV<TElement>)
+                {
+                    return FlatValue<TElement>::Load(_buffer, position);
+                }
+                else
+                {
+                    return FlatValue<TElement>::Load(_buffer, LoadFlat<FlatOffset>(_buffer, position));
+                }
+            }
+
+            Iterator begin() const
+            {
+                return Iterator(this, 0);
+            }
+
+            Iterator end() const
+            {
+                return Iterator(this, _size);
+            }
+
+        private:
+            static std::size_t constexpr ElementSize = []() {
+                if constexpr (IsFlatScalarV<TElement>)
+                {
+                    return sizeof(FlatStorageT<TElement>);
+                }
+                else
+                {
+                    return sizeof(FlatOffset);
+                }
+            }();
+
+            std::string_view _buffer;
+            std::size_t _size = 0;
+            std::size_t _elements = 0;
+    };
+}
+
+#endif // OPCOSERIALIZER_FLAT_VIEW_HPP
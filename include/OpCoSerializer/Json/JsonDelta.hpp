@@ -0,0 +1,205 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_DELTA_HPP
+#define OPCOSERIALIZER_JSON_DELTA_HPP
+
+#include <string>
+#include "rapidjson/document.h"
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Json/JsonReadContext.hpp"
+#include "OpCoSerializer/Json/JsonKeys.hpp"
+#include "OpCoSerializer/Json/JsonTypeSerializer.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// Writes the changes between two values of the same type, such that
+    /// applying them to the previous value with ApplyJsonDelta gives the
+    /// current value.
+    /// @remarks Values with serializable properties are written as an object
+    /// holding the delta of each changed property. Vectors are written as
+    /// {"size":3,"changes":[[1,delta],[2,value]]}, holding the delta of each
+    /// changed element, or its value if it is new. Any other value is written
+    /// in full.
+    /// @tparam T The type of the values.
+    /// @param writer The writer.
+    /// @param previous The previous value.
+    /// @param current The current value.
+    template <typename T, typename TWriter>
+    void WriteJsonDelta(TWriter& writer, T const& previous, T const& current)
+    {
+        if constexpr (HasSerializablePropertiesV<T>)
+        {
+            writer.StartObject();
+
+            std::size_t index = 0;
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                if (!SerializedEqual<Type>(previous.*(property.member), current.*(property.member)))
+                {
+                    JsonKeys<T>::Write(writer, index);
+                    WriteWithNumberFormat(writer, property, [&] {
+                        WriteJsonDelta<Type>(writer, previous.*(property.member), current.*(property.member));
+                    });
+                }
+
+                ++index;
+            });
+
+            writer.EndObject();
+        }
+        else if constexpr (IsVectorV<T>)
+        {
+            using TElement = typename T::value_type;
+
+            writer.StartObject();
+            writer.Key("size", 4);
+            writer.Uint64(current.size());
+            writer.Key("changes", 7);
+            writer.StartArray();
+
+            for (std::size_t i = 0; i < current.size(); ++i)
+            {
+                if (i >= previous.size())
+                {
+                    writer.StartArray();
+                    writer.Uint64(i);
+                    WriteJson<TElement>(writer, current[i]);
+                    writer.EndArray();
+                }
+                else if (!SerializedEqual<TElement>(previous[i], current[i]))
+                {
+                    writer.StartArray();
+                    writer.Uint64(i);
+                    WriteJsonDelta<TElement>(writer, previous[i], current[i]);
+                    writer.EndArray();
+                }
+            }
+
+            writer.EndArray();
+            writer.EndObject();
+        }
+        else
+        {
+            WriteJson<T>(writer, current);
+        }
+    }
+
+    /// Applies changes written by WriteJsonDelta to a value, patching it in
+    /// place.
+    /// @remarks The value must equal the previous value the delta was written
+    /// from. Unknown properties are ignored.
+    /// @tparam T The type of the value.
+    /// @param delta The delta.
+    /// @param value The value to patch.
+    template <typename T>
+    void ApplyJsonDelta(rapidjson::Value& delta, T& value)
+    {
+        if constexpr (HasSerializablePropertiesV<T>)
+        {
+            if (!delta.IsObject())
+            {
+                throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an object");
+            }
+
+            for (auto& member : delta.GetObject())
+            {
+                auto index = PropertyLookup<T>::Find(member.name.GetString(), member.name.GetStringLength());
+                if (index == PropertyLookup<T>::npos)
+                {
+                    continue;
+                }
+
+                ForPropertyAt<T>(index, [&](auto& property) {
+                    ApplyJsonDelta(member.value, value.*(property.member));
+                });
+            }
+        }
+        else if constexpr (IsVectorV<T>)
+        {
+            using TElement = typename T::value_type;
+
+            if (!delta.IsObject())
+            {
+                throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an object");
+            }
+
+            auto size = delta.FindMember("size");
+            auto changes = delta.FindMember("changes");
+            if (size == delta.MemberEnd() || !size->value.IsUint64() || changes == delta.MemberEnd() || !changes->value.IsArray())
+            {
+                throw OpCoSerializerException("Invalid vector in JSON delta - expected its size and changes");
+            }
+
+            auto count = static_cast<std::size_t>(size->value.GetUint64());
+            while (value.size() > count)
+            {
+                value.pop_back();
+            }
+
+            // Elements up to the previous size are patched, and any after are
+            // appended in order.
+            auto existing = value.size();
+            for (auto& change : changes->value.GetArray())
+            {
+                if (!change.IsArray() || change.Size() != 2 || !change[0].IsUint64())
+                {
+                    throw OpCoSerializerException("Invalid vector in JSON delta - expected an index and change");
+                }
+
+                auto index = change[0].GetUint64();
+                if (index < existing)
+                {
+                    if constexpr (std::is_same_v<TElement, bool>)
+                    {
+                        bool element = value[index];
+                        ApplyJsonDelta(change[1], element);
+                        value[index] = element;
+                    }
+                    else
+                    {
+                        ApplyJsonDelta(change[1], value[index]);
+                    }
+                }
+                else if (index == value.size() && index < count)
+                {
+                    value.push_back(JsonTypeSerializer<TElement>::Deserialize(change[1]));
+                }
+                else
+                {
+                    throw OpCoSerializerException("Invalid vector in JSON delta - element " + std::to_string(index) + " is out of order");
+                }
+            }
+
+            if (value.size() != count)
+            {
+                throw OpCoSerializerException("Invalid vector in JSON delta - missing elements");
+            }
+        }
+        else
+        {
+            static_assert(!std::is_same_v<T, std::string_view>, "A delta cannot be applied to a string view");
+            value = JsonTypeSerializer<T>::Deserialize(delta);
+        }
+    }
+}
+
+#endif // OPCOSERIALIZER_JSON_DELTA_HPP
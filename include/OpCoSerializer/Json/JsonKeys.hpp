@@ -0,0 +1,108 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_KEYS_HPP
+#define OPCOSERIALIZER_JSON_KEYS_HPP
+
+#include <array>
+#include <cstddef>
+#include "rapidjson/rapidjson.h"
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// The quoted keys of T's serializable properties, e.g. "name", escaped
+    /// at compile time so they are written as raw bytes.
+    /// @remarks Writers add the separator after each key, so pretty output is
+    /// unchanged. Property names which would need escaping in JSON are
+    /// rejected at compile time.
+    /// @tparam T The type with serializable properties.
+    template <typename T>
+    class JsonKeys final
+    {
+        public:
+            /// Writes the key of a property to a rapidjson writer.
+            /// @param writer The writer.
+            /// @param index The property index.
+            template <typename TWriter>
+            static void Write(TWriter& writer, std::size_t index)
+            {
+                writer.RawValue(text.data() + offsets[index], offsets[index + 1] - offsets[index], rapidjson::kStringType);
+            }
+
+        private:
+            static constexpr std::size_t count = PropertyCountV<T>;
+
+            static constexpr bool NeedsEscaping(char c) noexcept
+            {
+                return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+            }
+
+            static constexpr bool HasPlainNames()
+            {
+                bool plain = true;
+                ForProperty<T>([&](auto& property) {
+                    for (std::size_t i = 0; i < property.nameLength; ++i)
+                    {
+                        plain = plain && !NeedsEscaping(property.name[i]);
+                    }
+                });
+
+                return plain;
+            }
+
+            static constexpr std::array<std::size_t, count + 1> BuildOffsets()
+            {
+                std::array<std::size_t, count + 1> result{};
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    result[index + 1] = result[index] + property.nameLength + 2;
+                    ++index;
+                });
+
+                return result;
+            }
+
+            static constexpr std::array<std::size_t, count + 1> offsets = BuildOffsets();
+
+            static constexpr std::array<char, offsets[count]> BuildText()
+            {
+                static_assert(HasPlainNames(), "Serializable property names must not need escaping in JSON");
+
+                std::array<char, offsets[count]> result{};
+                std::size_t position = 0;
+                ForProperty<T>([&](auto& property) {
+                    result[position++] = '"';
+                    for (std::size_t i = 0; i < property.nameLength; ++i)
+                    {
+                        result[position++] = property.name[i];
+                    }
+
+                    result[position++] = '"';
+                });
+
+                return result;
+            }
+
+            static constexpr std::array<char, offsets[count]> text = BuildText();
+    };
+}
+
+#endif // OPCOSERIALIZER_JSON_KEYS_HPP
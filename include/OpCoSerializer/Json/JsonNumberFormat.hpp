@@ -0,0 +1,336 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_NUMBER_FORMAT_HPP
+#define OPCOSERIALIZER_JSON_NUMBER_FORMAT_HPP
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "rapidjson/writer.h"
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// How floating point values are written to JSON.
+    enum class JsonNumberFormat
+    {
+        /// The shortest decimal which reads back as the same double, e.g.
+        /// 0.30000000000000004.
+        Shortest,
+
+        /// The shortest decimal with at most a maximum number of decimal
+        /// places, e.g. 0.3 for 3 places. Digits beyond are truncated.
+        Fixed,
+
+        /// The shortest decimal which reads back as the same float, e.g. 0.3.
+        Float32,
+
+        /// The exact value as a hexadecimal floating point string, e.g.
+        /// "0x1.3333333333334p-2", which is written and read without decimal
+        /// conversion.
+        HexFloat
+    };
+
+    /// The default maximum number of decimal places for JsonNumberFormat::Fixed.
+    int constexpr JsonDefaultMaxDecimalPlaces = 6;
+
+    /// A property with its own number format, which applies to all floating
+    /// point values within it. Created by WithNumberFormat.
+    /// @tparam TProperty The type of the property.
+    template <typename TProperty>
+    struct JsonNumberFormatProperty final : TProperty
+    {
+        /// The number format.
+        JsonNumberFormat numberFormat;
+
+        /// The maximum number of decimal places for JsonNumberFormat::Fixed.
+        int maxDecimalPlaces;
+    };
+
+    /// Gives a property its own number format when written to JSON, e.g.
+    /// WithNumberFormat(MakeProperty(&Reading::value, "value"), JsonNumberFormat::Float32).
+    /// @remarks Other encodings ignore the number format.
+    /// @param property The property.
+    /// @param numberFormat The number format.
+    /// @param maxDecimalPlaces The maximum number of decimal places for
+    /// JsonNumberFormat::Fixed.
+    /// @returns The property with its number format.
+    template <typename TProperty>
+    constexpr auto WithNumberFormat(TProperty property, JsonNumberFormat numberFormat, int maxDecimalPlaces = JsonDefaultMaxDecimalPlaces)
+    {
+        return JsonNumberFormatProperty<TProperty>{ property, numberFormat, maxDecimalPlaces };
+    }
+
+    /// A rapidjson writer which writes floating point values in a
+    /// JsonNumberFormat.
+    /// @tparam TWriter The rapidjson writer, e.g. rapidjson::Writer or
+    /// rapidjson::PrettyWriter.
+    template <typename TWriter>
+    class JsonWriter final : public TWriter
+    {
+        public:
+            /// Whether or not the writer indents its output, e.g. a
+            /// rapidjson::PrettyWriter.
+            static bool constexpr isPretty = requires (TWriter& writer) { writer.SetIndent(' ', 4u); };
+
+            using TWriter::TWriter;
+
+            /// Gets the number format.
+            /// @returns The number format.
+            JsonNumberFormat GetNumberFormat() const
+            {
+                return _numberFormat;
+            }
+
+            /// Gets the maximum number of decimal places for
+            /// JsonNumberFormat::Fixed.
+            /// @returns The maximum number of decimal places.
+            int GetMaxDecimalPlaces() const
+            {
+                return _maxDecimalPlaces;
+            }
+
+            /// Sets the number format.
+            /// @param numberFormat The number format.
+            /// @param maxDecimalPlaces The maximum number of decimal places for
+            /// JsonNumberFormat::Fixed.
+            void SetNumberFormat(JsonNumberFormat numberFormat, int maxDecimalPlaces)
+            {
+                _numberFormat = numberFormat;
+                _maxDecimalPlaces = maxDecimalPlaces;
+                TWriter::SetMaxDecimalPlaces(numberFormat == JsonNumberFormat::Fixed ? maxDecimalPlaces : TWriter::kDefaultMaxDecimalPlaces);
+            }
+
+            /// Writes a floating point value in the number format.
+            /// @param d The value.
+            /// @returns False if the value is not finite, or does not fit in a
+            /// float for JsonNumberFormat::Float32.
+            bool Double(double d)
+            {
+                if (_numberFormat != JsonNumberFormat::Float32 && _numberFormat != JsonNumberFormat::HexFloat)
+                {
+                    return TWriter::Double(d);
+                }
+
+                char buffer[numberLength];
+                auto end = Format(buffer, d);
+                if (end == nullptr)
+                {
+                    return false;
+                }
+
+                auto type = _numberFormat == JsonNumberFormat::HexFloat ? rapidjson::kStringType : rapidjson::kNumberType;
+                return TWriter::RawValue(buffer, static_cast<std::size_t>(end - buffer), type);
+            }
+
+            /// Writes numbers as the elements of an array which has been
+            /// started, formatting them in bulk.
+            /// @remarks The numbers are formatted into a buffer, with commas
+            /// between them, which is written as a single raw value whenever
+            /// it fills up. The writer adds the comma between buffers, so the
+            /// output is the same as writing each number. Pretty writers put
+            /// each element on its own line, so write the numbers one by one.
+            /// @param values The numbers.
+            /// @param count The number of numbers.
+            /// @returns False if a floating point value could not be written,
+            /// as for Double.
+            template <typename T>
+                requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !isPretty)
+            bool WriteNumbers(T const* values, std::size_t count)
+            {
+                char buffer[numberBufferLength];
+                std::size_t length = 0;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (length > numberBufferLength - numberLength - 1)
+                    {
+                        TWriter::RawValue(buffer, length - 1, rapidjson::kNumberType);
+                        length = 0;
+                    }
+
+                    auto end = Format(buffer + length, values[i]);
+                    if (end == nullptr)
+                    {
+                        return false;
+                    }
+
+                    *end++ = ',';
+                    length = static_cast<std::size_t>(end - buffer);
+                }
+
+                if (length != 0)
+                {
+                    TWriter::RawValue(buffer, length - 1, rapidjson::kNumberType);
+                }
+
+                return true;
+            }
+
+        private:
+            // Room for the longest number in any format, e.g. the hex float
+            // "-0x1.fffffffffffffp-1022", with its quotes.
+            static std::size_t constexpr numberLength = 32;
+            static std::size_t constexpr numberBufferLength = 4096;
+
+            JsonNumberFormat _numberFormat = JsonNumberFormat::Shortest;
+            int _maxDecimalPlaces = JsonDefaultMaxDecimalPlaces;
+
+            // Formats a number as the writer would, returning the end of the
+            // characters, or null if it cannot be written.
+            template <typename T>
+            char* Format(char* buffer, T value) const
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    auto d = static_cast<double>(value);
+                    switch (_numberFormat)
+                    {
+                        case JsonNumberFormat::Float32:
+                            return FormatFloat32(buffer, d);
+                        case JsonNumberFormat::HexFloat:
+                            return FormatHexFloat(buffer, d);
+                        default:
+                            return std::isfinite(d) ? rapidjson::internal::dtoa(d, buffer, this->maxDecimalPlaces_) : nullptr;
+                    }
+                }
+                else if constexpr (std::is_signed_v<T>)
+                {
+                    if constexpr (sizeof(T) <= sizeof(int32_t))
+                    {
+                        return rapidjson::internal::i32toa(static_cast<int32_t>(value), buffer);
+                    }
+                    else
+                    {
+                        return rapidjson::internal::i64toa(static_cast<int64_t>(value), buffer);
+                    }
+                }
+                else
+                {
+                    if constexpr (sizeof(T) <= sizeof(uint32_t))
+                    {
+                        return rapidjson::internal::u32toa(static_cast<uint32_t>(value), buffer);
+                    }
+                    else
+                    {
+                        return rapidjson::internal::u64toa(static_cast<uint64_t>(value), buffer);
+                    }
+                }
+            }
+
+            static char* FormatFloat32(char* buffer, double d)
+            {
+                auto single = static_cast<float>(d);
+                if (!std::isfinite(single))
+                {
+                    return nullptr;
+                }
+
+                return std::to_chars(buffer, buffer + numberLength, single).ptr;
+            }
+
+            static char* FormatHexFloat(char* buffer, double d)
+            {
+                if (!std::isfinite(d))
+                {
+                    return nullptr;
+                }
+
+                // The sign goes before the 0x prefix, which std::to_chars
+                // does not write.
+                auto current = buffer;
+                *current++ = '"';
+                if (std::signbit(d))
+                {
+                    *current++ = '-';
+                    d = -d;
+                }
+
+                *current++ = '0';
+                *current++ = 'x';
+                current = std::to_chars(current, buffer + numberLength - 1, d, std::chars_format::hex).ptr;
+                *current++ = '"';
+                return current;
+            }
+    };
+
+    /// Writes a property's value, in the property's number format if it was
+    /// given one by WithNumberFormat and the writer is a JsonWriter.
+    /// @param writer The writer.
+    /// @param property The property.
+    /// @param write Writes the value.
+    template <typename TWriter, typename TProperty, typename TWrite>
+    void WriteWithNumberFormat(TWriter& writer, TProperty const& property, TWrite&& write)
+    {
+        if constexpr (requires { writer.SetNumberFormat(property.numberFormat, property.maxDecimalPlaces); })
+        {
+            auto numberFormat = writer.GetNumberFormat();
+            auto maxDecimalPlaces = writer.GetMaxDecimalPlaces();
+            writer.SetNumberFormat(property.numberFormat, property.maxDecimalPlaces);
+            write();
+            writer.SetNumberFormat(numberFormat, maxDecimalPlaces);
+        }
+        else
+        {
+            write();
+        }
+    }
+
+    /// Parses a floating point value written with JsonNumberFormat::HexFloat.
+    /// @param string The characters, e.g. -0x1.8p+1.
+    /// @param length The number of characters.
+    /// @param value Set to the parsed value.
+    /// @returns Whether or not the characters are a hexadecimal floating point
+    /// value.
+    inline bool ParseJsonHexFloat(char const* string, std::size_t length, double& value)
+    {
+        auto end = string + length;
+        bool negative = string != end && *string == '-';
+        if (negative)
+        {
+            ++string;
+        }
+
+        // std::from_chars also accepts a sign, inf and nan after the prefix.
+        if (end - string < 3 || string[0] != '0' || (string[1] != 'x' && string[1] != 'X') ||
+            (!std::isxdigit(static_cast<unsigned char>(string[2])) && string[2] != '.'))
+        {
+            return false;
+        }
+
+        auto result = std::from_chars(string + 2, end, value, std::chars_format::hex);
+        if (result.ec != std::errc() || result.ptr != end)
+        {
+            return false;
+        }
+
+        if (negative)
+        {
+            value = -value;
+        }
+
+        return true;
+    }
+}
+
+#endif // OPCOSERIALIZER_JSON_NUMBER_FORMAT_HPP
@@ -0,0 +1,599 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_READ_CONTEXT_HPP
+#define OPCOSERIALIZER_JSON_READ_CONTEXT_HPP
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Json/JsonNumberFormat.hpp"
+
+namespace OpCoSerializer::Json
+{
+    template <typename T>
+    struct JsonTypeSerializer;
+
+    class JsonReadContext;
+    struct JsonToken;
+
+    template <typename T>
+    void ReadJson(JsonReadContext& context, T& value, JsonToken const& token);
+
+    /// The rapidjson parse flags used to read every value.
+    /// @remarks Numbers are parsed with full precision, so doubles are
+    /// correctly rounded whether they are read from memory, a file or a
+    /// stream, and whether or not they are read in bulk through
+    /// std::from_chars, e.g. in a vector of numbers.
+    unsigned constexpr JsonParseFlags = rapidjson::kParseFullPrecisionFlag;
+
+    /// The type of a token produced by the JSON parser.
+    enum class JsonTokenType
+    {
+        Null,
+        Bool,
+        Int,
+        Uint,
+        Double,
+        String,
+        Key,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray
+    };
+
+    /// A single token produced by the JSON parser.
+    /// @remarks String data is only valid until the next token is produced,
+    /// unless copy is false (e.g. when parsing in situ).
+    struct JsonToken final
+    {
+        /// The token type.
+        JsonTokenType type = JsonTokenType::Null;
+
+        /// The value of a Bool token.
+        bool boolean = false;
+
+        /// The value of an Int token.
+        int64_t integer = 0;
+
+        /// The value of a Uint token.
+        uint64_t unsignedInteger = 0;
+
+        /// The value of a Double token.
+        double number = 0.0;
+
+        /// The characters of a String or Key token.
+        char const* string = nullptr;
+
+        /// The length of a String or Key token.
+        std::size_t length = 0;
+
+        /// Whether or not the characters of a String or Key token are transient.
+        bool copy = true;
+
+        /// Whether or not the token begins an object or array.
+        bool IsStart() const
+        {
+            return type == JsonTokenType::StartObject || type == JsonTokenType::StartArray;
+        }
+
+        /// Whether or not the token ends an object or array.
+        bool IsEnd() const
+        {
+            return type == JsonTokenType::EndObject || type == JsonTokenType::EndArray;
+        }
+
+        /// Converts a numeric or boolean token to the given arithmetic type.
+        /// @remarks Throws if the token is not a number, or if the number does
+        /// not fit into T. Floating point values may also be strings written
+        /// with JsonNumberFormat::HexFloat.
+        /// @tparam T The arithmetic type.
+        /// @returns The converted value.
+        template <typename T>
+        T GetNumber() const
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (type != JsonTokenType::Bool)
+                {
+                    ThrowUnexpected("a boolean");
+                }
+
+                return boolean;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                switch (type)
+                {
+                    case JsonTokenType::Int:
+                        return static_cast<T>(integer);
+                    case JsonTokenType::Uint:
+                        return static_cast<T>(unsignedInteger);
+                    case JsonTokenType::Double:
+                        return static_cast<T>(number);
+                    case JsonTokenType::String:
+                    {
+                        double parsed;
+                        if (!ParseJsonHexFloat(string, length, parsed))
+                        {
+                            ThrowUnexpected("a number");
+                        }
+
+                        return static_cast<T>(parsed);
+                    }
+                    default:
+                        ThrowUnexpected("a number");
+                }
+            }
+            else
+            {
+                using Limits = std::numeric_limits<T>;
+                if (type == JsonTokenType::Int)
+                {
+                    bool inRange;
+                    if constexpr (std::is_signed_v<T>)
+                    {
+                        inRange = integer >= static_cast<int64_t>(Limits::min()) && integer <= static_cast<int64_t>(Limits::max());
+                    }
+                    else
+                    {
+                        inRange = integer >= 0 && static_cast<uint64_t>(integer) <= static_cast<uint64_t>(Limits::max());
+                    }
+
+                    if (!inRange)
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+
+                    return static_cast<T>(integer);
+                }
+
+                if (type == JsonTokenType::Uint)
+                {
+                    if (unsignedInteger > static_cast<uint64_t>(Limits::max()))
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+
+                    return static_cast<T>(unsignedInteger);
+                }
+
+                ThrowUnexpected("an integer");
+            }
+        }
+
+        /// Throws an exception reporting that the token was not what was expected.
+        /// @param expected A description of the expected value.
+        [[noreturn]] void ThrowUnexpected(char const* expected) const
+        {
+            throw OpCoSerializerException(std::string("Unexpected JSON value during deserialization - expected ") + expected);
+        }
+    };
+
+    /// An open object or array that is being read.
+    struct JsonReadFrame final
+    {
+        /// Handles the tokens read within the object or array.
+        /// @remarks The frame reference may be invalidated by pushing
+        /// another frame, so handlers update their state first.
+        void (*handler)(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token);
+
+        /// The value being read into.
+        void* target;
+
+        /// Handler specific state, e.g. the number of elements read.
+        std::size_t state;
+
+        /// The offset of this frame's property flags in the context.
+        std::size_t seenOffset;
+
+        /// Whether or not all properties must be present.
+        bool required;
+
+        /// Frees the target if the frame is abandoned, e.g. after a failed
+        /// parse. Null if the frame does not own its target.
+        void (*release)(void* target);
+    };
+
+    /// Reads JSON straight into values as tokens arrive from a rapidjson
+    /// reader, without building a document.
+    /// @remarks This type is a rapidjson SAX handler. Objects and arrays that
+    /// are being read are tracked on a stack of frames, whilst the value that
+    /// the next token belongs to is set with Expect.
+    class JsonReadContext final
+    {
+        public:
+            /// Initializes a new instance of the JsonReadContext type.
+            /// @param propertiesRequired Whether or not all properties of the
+            /// root object must be present.
+            explicit JsonReadContext(bool propertiesRequired = false)
+                : _propertiesRequired(propertiesRequired)
+            {
+            }
+
+            ~JsonReadContext()
+            {
+                ReleaseFrames();
+            }
+
+            /// Sets the value that the next token (and any tokens nested
+            /// within it) is read into.
+            /// @param target The value.
+            template <typename T>
+            void Expect(T& target)
+            {
+                _pending = Pending{ &ReadPending<T>, &target };
+            }
+
+            /// Sets the value that the next token (and any tokens nested
+            /// within it) is read into, for a type which is constructed from
+            /// the values of its properties once they have all been read.
+            /// @param target Receives the constructed value.
+            template <typename T>
+            void ExpectConstructed(std::optional<T>& target)
+            {
+                _pending = Pending{ &ReadPendingConstructed<T>, &target };
+            }
+
+            /// Sets the function that reads the next token (and any tokens
+            /// nested within it), for values which are not read through a
+            /// JsonTypeSerializer, e.g. a column of a Columnar vector.
+            /// @param read The function.
+            /// @param target Passed to the function.
+            void ExpectWith(void (*read)(JsonReadContext& context, void* target, JsonToken const& token), void* target)
+            {
+                _pending = Pending{ read, target };
+            }
+
+            /// Skips the next value.
+            void Skip()
+            {
+                _pending = Pending{ &SkipPending, nullptr };
+            }
+
+            /// Pushes a frame for an object or array which has just been started.
+            /// @param handler The function that handles the tokens read within
+            /// the object or array.
+            /// @param target The value being read into.
+            /// @param trackedProperties The number of properties to track the
+            /// presence of. Only tracked when PropertiesRequired is true.
+            /// @param release Frees the target if the frame is abandoned.
+            void Push(
+                decltype(JsonReadFrame::handler) handler,
+                void* target,
+                std::size_t trackedProperties = 0,
+                decltype(JsonReadFrame::release) release = nullptr)
+            {
+                auto required = PropertiesRequired() && trackedProperties > 0;
+                auto seenOffset = _seen.size();
+                if (required)
+                {
+                    _seen.resize(seenOffset + (trackedProperties + 63) / 64);
+                }
+
+                _frames.push_back(JsonReadFrame{ handler, target, 0, seenOffset, required, release });
+            }
+
+            /// Gets the current frame.
+            /// @returns The frame.
+            JsonReadFrame& Top()
+            {
+                return _frames.back();
+            }
+
+            /// Pops the current frame.
+            void Pop()
+            {
+                _seen.resize(_frames.back().seenOffset);
+                _frames.pop_back();
+            }
+
+            /// Marks the property at the given index as present in the frame.
+            /// @param frame The frame.
+            /// @param index The property index.
+            void MarkSeen(JsonReadFrame const& frame, std::size_t index)
+            {
+                _seen[frame.seenOffset + index / 64] |= uint64_t{1} << (index % 64);
+            }
+
+            /// Checks whether the property at the given index is present in the frame.
+            /// @param frame The frame.
+            /// @param index The property index.
+            /// @returns Whether or not the property was seen.
+            bool Seen(JsonReadFrame const& frame, std::size_t index) const
+            {
+                return (_seen[frame.seenOffset + index / 64] >> (index % 64)) & 1;
+            }
+
+            /// Whether or not all properties of an object that is about to be
+            /// pushed must be present.
+            /// @remarks Properties of nested objects are always required.
+            bool PropertiesRequired() const
+            {
+                return _propertiesRequired || !_frames.empty();
+            }
+
+            /// Whether or not a complete value has been read.
+            bool IsComplete() const
+            {
+                return _frames.empty() && _pending.read == nullptr;
+            }
+
+            /// Sets the characters being parsed, for handlers which read values
+            /// straight from them rather than token by token, e.g. arrays of
+            /// numbers.
+            /// @remarks Handlers may only advance the position to the start of
+            /// a value or to the end of an array, from where the parser then
+            /// carries on.
+            /// @param position The parser's position, or null if the input is
+            /// not in memory, e.g. a file.
+            /// @param end The end of the input.
+            void SetInput(char const** position, char const* end)
+            {
+                _inputPosition = position;
+                _inputEnd = end;
+            }
+
+            /// Sets the input being parsed from the given rapidjson stream.
+            /// @remarks Only a rapidjson::MemoryStream is read from directly.
+            /// It has no accessor for its position, so this is the one place
+            /// which uses its src_ member, the position the parser advances.
+            /// Other streams, e.g. files, are read token by token.
+            /// @param stream The stream.
+            template <typename TStream>
+            void SetInput(TStream& stream)
+            {
+                if constexpr (std::is_same_v<TStream, rapidjson::MemoryStream>)
+                {
+                    SetInput(&stream.src_, stream.end_);
+                }
+                else
+                {
+                    SetInput(nullptr, nullptr);
+                }
+            }
+
+            /// Gets the parser's position in the input set by SetInput.
+            /// @returns The position, or null if the input is not in memory.
+            char const** InputPosition() const
+            {
+                return _inputPosition;
+            }
+
+            /// Gets the end of the input set by SetInput.
+            /// @returns The end of the input.
+            char const* InputEnd() const
+            {
+                return _inputEnd;
+            }
+
+            /// Clears any partially read state, e.g. after a failed parse.
+            void Reset()
+            {
+                ReleaseFrames();
+                _frames.clear();
+                _seen.clear();
+                _pending = Pending{};
+            }
+
+            /// Reads a value through a rapidjson document, for types without a
+            /// streaming Read function.
+            /// @param target The value.
+            /// @param token The first token of the value.
+            template <typename T>
+            void ReadThroughDocument(T& target, JsonToken const& token)
+            {
+                _recordBuffer.Clear();
+                _recordWriter.Reset(_recordBuffer);
+                Record(token);
+
+                if (token.IsStart())
+                {
+                    Push(&ReadRecorded<T>, &target);
+                    _frames.back().state = 1;
+                }
+                else
+                {
+                    CompleteRecording(target);
+                }
+            }
+
+            /// @name rapidjson handler implementation.
+            /// @{
+            bool Null() { return Dispatch(JsonToken{ .type = JsonTokenType::Null }); }
+            bool Bool(bool b) { return Dispatch(JsonToken{ .type = JsonTokenType::Bool, .boolean = b }); }
+            bool Int(int i) { return Dispatch(JsonToken{ .type = JsonTokenType::Int, .integer = i }); }
+            bool Uint(unsigned u) { return Dispatch(JsonToken{ .type = JsonTokenType::Uint, .unsignedInteger = u }); }
+            bool Int64(int64_t i) { return Dispatch(JsonToken{ .type = JsonTokenType::Int, .integer = i }); }
+            bool Uint64(uint64_t u) { return Dispatch(JsonToken{ .type = JsonTokenType::Uint, .unsignedInteger = u }); }
+            bool Double(double d) { return Dispatch(JsonToken{ .type = JsonTokenType::Double, .number = d }); }
+            bool RawNumber(char const*, rapidjson::SizeType, bool) { return Dispatch(JsonToken{}); }
+            bool String(char const* s, rapidjson::SizeType length, bool copy)
+            {
+                return Dispatch(JsonToken{ .type = JsonTokenType::String, .string = s, .length = length, .copy = copy });
+            }
+            bool StartObject() { return Dispatch(JsonToken{ .type = JsonTokenType::StartObject }); }
+            bool Key(char const* s, rapidjson::SizeType length, bool copy)
+            {
+                return Dispatch(JsonToken{ .type = JsonTokenType::Key, .string = s, .length = length, .copy = copy });
+            }
+            bool EndObject(rapidjson::SizeType) { return Dispatch(JsonToken{ .type = JsonTokenType::EndObject }); }
+            bool StartArray() { return Dispatch(JsonToken{ .type = JsonTokenType::StartArray }); }
+            bool EndArray(rapidjson::SizeType) { return Dispatch(JsonToken{ .type = JsonTokenType::EndArray }); }
+            /// @}
+
+        private:
+            struct Pending final
+            {
+                void (*read)(JsonReadContext& context, void* target, JsonToken const& token) = nullptr;
+                void* target = nullptr;
+            };
+
+            bool _propertiesRequired;
+            Pending _pending;
+            char const** _inputPosition = nullptr;
+            char const* _inputEnd = nullptr;
+            std::vector<JsonReadFrame> _frames;
+            std::vector<uint64_t> _seen;
+            rapidjson::StringBuffer _recordBuffer;
+            rapidjson::Writer<rapidjson::StringBuffer> _recordWriter;
+            rapidjson::Document _recordDocument;
+
+            bool Dispatch(JsonToken const& token)
+            {
+                if (_pending.read != nullptr)
+                {
+                    auto pending = _pending;
+                    _pending = Pending{};
+                    pending.read(*this, pending.target, token);
+                }
+                else if (!_frames.empty())
+                {
+                    auto& frame = _frames.back();
+                    frame.handler(*this, frame, token);
+                }
+                else
+                {
+                    throw OpCoSerializerException("Unexpected JSON value after the end of the deserialized value");
+                }
+
+                return true;
+            }
+
+            template <typename T>
+            static void ReadPending(JsonReadContext& context, void* target, JsonToken const& token)
+            {
+                ReadJson(context, *static_cast<T*>(target), token);
+            }
+
+            template <typename T>
+            static void ReadPendingConstructed(JsonReadContext& context, void* target, JsonToken const& token)
+            {
+                JsonTypeSerializer<T>::Construct(context, token, target, [](void* destination, T&& value) {
+                    static_cast<std::optional<T>*>(destination)->emplace(std::move(value));
+                });
+            }
+
+            void ReleaseFrames()
+            {
+                for (auto frame = _frames.rbegin(); frame != _frames.rend(); ++frame)
+                {
+                    if (frame->release != nullptr)
+                    {
+                        frame->release(frame->target);
+                    }
+                }
+            }
+
+            static void SkipPending(JsonReadContext& context, void*, JsonToken const& token)
+            {
+                if (token.IsStart())
+                {
+                    context.Push(&SkipNested, nullptr);
+                    context._frames.back().state = 1;
+                }
+            }
+
+            static void SkipNested(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                if (token.IsStart())
+                {
+                    ++frame.state;
+                }
+                else if (token.IsEnd() && --frame.state == 0)
+                {
+                    context.Pop();
+                }
+            }
+
+            template <typename T>
+            static void ReadRecorded(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                context.Record(token);
+
+                if (token.IsStart())
+                {
+                    ++frame.state;
+                }
+                else if (token.IsEnd() && --frame.state == 0)
+                {
+                    auto& target = *static_cast<T*>(frame.target);
+                    context.Pop();
+                    context.CompleteRecording(target);
+                }
+            }
+
+            void Record(JsonToken const& token)
+            {
+                auto& writer = _recordWriter;
+                switch (token.type)
+                {
+                    case JsonTokenType::Null: writer.Null(); break;
+                    case JsonTokenType::Bool: writer.Bool(token.boolean); break;
+                    case JsonTokenType::Int: writer.Int64(token.integer); break;
+                    case JsonTokenType::Uint: writer.Uint64(token.unsignedInteger); break;
+                    case JsonTokenType::Double: writer.Double(token.number); break;
+                    case JsonTokenType::String:
+                        writer.String(token.string, static_cast<rapidjson::SizeType>(token.length));
+                        break;
+                    case JsonTokenType::Key:
+                        writer.Key(token.string, static_cast<rapidjson::SizeType>(token.length));
+                        break;
+                    case JsonTokenType::StartObject: writer.StartObject(); break;
+                    case JsonTokenType::EndObject: writer.EndObject(); break;
+                    case JsonTokenType::StartArray: writer.StartArray(); break;
+                    case JsonTokenType::EndArray: writer.EndArray(); break;
+                }
+            }
+
+            template <typename T>
+            void CompleteRecording(T& target)
+            {
+                // The document is reused, clearing its memory pool each time
+                // as values released by a parse are not otherwise reclaimed.
+                _recordDocument.GetAllocator().Clear();
+                _recordDocument.Parse<JsonParseFlags>(_recordBuffer.GetString(), _recordBuffer.GetSize());
+                target = JsonTypeSerializer<T>::Deserialize(_recordDocument);
+            }
+    };
+
+    /// Throws an exception describing a failed parse.
+    /// @param result The result of the parse.
+    /// @param source A description of what was being parsed.
+    [[noreturn]] inline void ThrowParseError(rapidjson::ParseResult const& result, std::string const& source)
+    {
+        auto message = "Error whilst parsing " + source + " - "
+            + rapidjson::GetParseError_En(result.Code())
+            + " (offset " + std::to_string(result.Offset()) + ")";
+        throw OpCoSerializerException(message);
+    }
+}
+
+#endif // OPCOSERIALIZER_JSON_READ_CONTEXT_HPP
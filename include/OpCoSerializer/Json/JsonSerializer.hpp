@@ -21,109 +21,596 @@
 #ifndef OPCOSERIALIZER_JSON_SERIALIZER_HPP
 #define OPCOSERIALIZER_JSON_SERIALIZER_HPP
 
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <variant>
 #include "rapidjson/document.h"
-#include "rapidjson/stringbuffer.h"
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/memorystream.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/prettywriter.h"
 #include "OpCoSerializer/Common.hpp"
 #include "OpCoSerializer/Json/JsonSerializerSettings.hpp"
+#include "OpCoSerializer/Json/JsonReadContext.hpp"
+#include "OpCoSerializer/Json/JsonNumberFormat.hpp"
+#include "OpCoSerializer/Json/JsonStreams.hpp"
+#include "OpCoSerializer/Json/JsonKeys.hpp"
 #include "OpCoSerializer/Json/JsonTypeSerializer.hpp"
+#include "OpCoSerializer/Json/JsonDelta.hpp"
 
 namespace OpCoSerializer::Json
 {
-    /// Serializes objects to and from JSON.
-    class JsonSerializer final
+    /// Serializes objects to and from JSON, with settings fixed at compile
+    /// time by a policy.
+    /// @remarks Only the writer chosen by the policy is compiled, so unlike
+    /// JsonSerializer no call branches on its settings.
+    /// The output buffer, writers, parser stack and read state are kept
+    /// between calls and reset rather than freed, so once warmed up,
+    /// serializing into an existing string does not allocate. As a result, a
+    /// BasicJsonSerializer must not be used from multiple threads at once.
+    /// @tparam TPolicy The policy, e.g. JsonSerializerPolicy<true> for pretty
+    /// output. See JsonSerializerPolicy for the members it must have.
+    template <typename TPolicy = JsonSerializerPolicy<>>
+    class BasicJsonSerializer final
     {
         public:
-            /// Initializes a new instance of the JsonSerializer type.
-            /// @param settings The settings.
-            explicit JsonSerializer(JsonSerializerSettings&& settings = JsonSerializerSettings())
-                : _settings(settings)
+            /// The policy.
+            using Policy = TPolicy;
+
+            /// Initializes a new instance of the BasicJsonSerializer type.
+            /// @param numberFormat How floating point values are written.
+            /// Properties can override it through WithNumberFormat.
+            /// @param maxDecimalPlaces The maximum number of decimal places for
+            /// JsonNumberFormat::Fixed.
+            explicit BasicJsonSerializer(
+                JsonNumberFormat numberFormat = JsonNumberFormat::Shortest,
+                int maxDecimalPlaces = JsonDefaultMaxDecimalPlaces)
+                : _numberFormat(numberFormat),
+                  _maxDecimalPlaces(maxDecimalPlaces)
+            {
+            }
+
+            /// Initializes a new instance of the BasicJsonSerializer type as a
+            /// copy of another. The reusable buffers are not shared.
+            /// @param other The other serializer.
+            BasicJsonSerializer(BasicJsonSerializer const& other)
+                : _numberFormat(other._numberFormat),
+                  _maxDecimalPlaces(other._maxDecimalPlaces)
             {
             }
 
+            BasicJsonSerializer(BasicJsonSerializer&& other) noexcept = default;
+
+            BasicJsonSerializer& operator=(BasicJsonSerializer const& other)
+            {
+                _numberFormat = other._numberFormat;
+                _maxDecimalPlaces = other._maxDecimalPlaces;
+                _state.reset();
+                return *this;
+            }
+
+            BasicJsonSerializer& operator=(BasicJsonSerializer&& other) noexcept = default;
+
             /// Serializes the given value to JSON.
+            /// @remarks The value is written straight to the output buffer
+            /// without building an intermediate document.
             /// @tparam T the type of the value to serialize.
             /// @param value The value.
             /// @returns The serialized string.
             template <typename T>
             std::string Serialize(T const& value)
             {
-                using namespace rapidjson;
-
-                Document document;
-                document.SetObject();
-
-                ForProperty<T>([&](auto& property) {
-                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
-                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
-                    auto propertyValue = value.*(property.member);
-                    auto key = std::string(property.name);
-                    document.AddMember(
-                        rapidjson::Value(key.c_str(), key.size(), document.GetAllocator()),
-                        JsonTypeSerializer<Type>::Serialize(document, propertyValue),
-                        document.GetAllocator()
-                    );
+                std::string serialized;
+                Serialize(value, serialized);
+                return serialized;
+            }
+
+            /// Serializes the given value to JSON into an existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// The string is sized once to SerializedSizeBound(value) and the
+            /// JSON is written straight into it.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                WriteToString(serialized, SerializedSizeBound(value), [&](auto& writer) {
+                    WriteJson(writer, value);
                 });
+            }
+
+            /// Serializes the given value to JSON, writing it to a file.
+            /// @remarks The JSON is written through a fixed size buffer, so
+            /// memory use does not depend on the size of the value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param file The file, opened for writing.
+            template <typename T>
+            void Serialize(T const& value, std::FILE* file)
+            {
+                rapidjson::FileWriteStream stream(file, GetStreamBuffer(), JsonStreamBufferSize);
+                WriteTo(stream, value);
+                if (std::ferror(file))
+                {
+                    throw OpCoSerializerException("Error whilst writing JSON to file");
+                }
+            }
+
+            /// Serializes the given value to JSON, writing it to a stream.
+            /// @remarks The JSON is written through a fixed size buffer, so
+            /// memory use does not depend on the size of the value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param output The stream.
+            template <typename T>
+            void Serialize(T const& value, std::ostream& output)
+            {
+                OStreamWriteStream stream(output, GetStreamBuffer(), JsonStreamBufferSize);
+                WriteTo(stream, value);
+                if (!output)
+                {
+                    throw OpCoSerializerException("Error whilst writing JSON to stream");
+                }
+            }
 
-                return _settings.pretty
-                    ? StringifyDocument<PrettyWriter<StringBuffer>>(document)
-                    : StringifyDocument<Writer<StringBuffer>>(document);
+            /// Serializes the given value to JSON, writing it to the file at
+            /// the given path. Any existing file is replaced.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param path The file path.
+            template <typename T>
+            void SerializeToFile(T const& value, std::filesystem::path const& path)
+            {
+                auto file = OpenFile(path, "wb");
+                Serialize(value, file.get());
             }
 
             /// Deserializes the string to a value of type T.
+            /// @remarks The string is read up to its length, so it need not be
+            /// null terminated, e.g. a slice of a larger receive buffer.
             /// @tparam T the type of the value to deserialize to.
             /// @param serializedString The serialized string.
             /// @returns The deserialized value.
             template <typename T>
-            T Deserialize(std::string const& serializedString)
+            T Deserialize(std::string_view serializedString)
+            {
+                rapidjson::MemoryStream stream(serializedString.data(), serializedString.size());
+                return ReadFrom<T>(stream);
+            }
+
+            /// Deserializes the characters to a value of type T.
+            /// @remarks The characters need not be null terminated.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized characters.
+            /// @param length The number of characters.
+            /// @returns The deserialized value.
+            template <typename T>
+            T Deserialize(char const* serialized, std::size_t length)
+            {
+                return Deserialize<T>(std::string_view(serialized, length));
+            }
+
+            /// Deserializes the string into an existing value, overwriting its
+            /// members in place.
+            /// @remarks The capacity of strings and vectors, and the elements of
+            /// vectors, are reused, so once warmed up, repeatedly reading the
+            /// same shape of value does not allocate. Members missing from the
+            /// string keep their current values.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serializedString The serialized string.
+            /// @param target The value to deserialize into.
+            template <typename T>
+            void DeserializeInto(std::string_view serializedString, T& target)
+            {
+                rapidjson::MemoryStream stream(serializedString.data(), serializedString.size());
+                Read(stream, target);
+            }
+
+            /// Deserializes the buffer to a value of type T, parsing it in
+            /// situ.
+            /// @remarks Strings are decoded in place, overwriting the buffer.
+            /// std::string_view members refer to the decoded strings within the
+            /// buffer, so the buffer must outlive the value, but reading them
+            /// does not allocate.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param buffer The serialized string, which is overwritten.
+            /// @returns The deserialized value.
+            template <typename T>
+            T DeserializeInsitu(std::span<char> buffer)
+            {
+                InsituMemoryStream stream(buffer.data(), buffer.size());
+                return ReadFrom<T, JsonParseFlags | rapidjson::kParseInsituFlag>(stream);
+            }
+
+            /// Deserializes a value of type T, reading it from a file.
+            /// @remarks The JSON is read through a fixed size buffer, so memory
+            /// use does not depend on the size of the document. The file may be
+            /// read beyond the end of the value.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param file The file, opened for reading.
+            /// @returns The deserialized value.
+            template <typename T>
+            T Deserialize(std::FILE* file)
+            {
+                rapidjson::FileReadStream stream(file, GetStreamBuffer(), JsonStreamBufferSize);
+                return ReadFrom<T>(stream);
+            }
+
+            /// Deserializes a value of type T, reading it from a stream.
+            /// @remarks The JSON is read through a fixed size buffer, so memory
+            /// use does not depend on the size of the document. The stream may
+            /// be read beyond the end of the value.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param input The stream.
+            /// @returns The deserialized value.
+            template <typename T>
+            T Deserialize(std::istream& input)
+            {
+                IStreamReadStream stream(input, GetStreamBuffer(), JsonStreamBufferSize);
+                return ReadFrom<T>(stream);
+            }
+
+            /// Deserializes a value of type T, reading it from the file at the
+            /// given path.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param path The file path.
+            /// @returns The deserialized value.
+            template <typename T>
+            T DeserializeFromFile(std::filesystem::path const& path)
+            {
+                auto file = OpenFile(path, "rb");
+                return Deserialize<T>(file.get());
+            }
+
+            /// Serializes the changes from one value to another to JSON.
+            /// @remarks Only the properties and vector elements which differ
+            /// are written, recursively (see WriteJsonDelta), so a stream of
+            /// values which change little can be stored as a full value
+            /// followed by deltas.
+            /// @tparam T the type of the values.
+            /// @param previous The previous value.
+            /// @param current The current value.
+            /// @returns The serialized delta.
+            template <typename T>
+            std::string SerializeDelta(T const& previous, T const& current)
+            {
+                std::string serialized;
+                SerializeDelta(previous, current, serialized);
+                return serialized;
+            }
+
+            /// Serializes the changes from one value to another to JSON into an
+            /// existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the values.
+            /// @param previous The previous value.
+            /// @param current The current value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+            void SerializeDelta(T const& previous, T const& current, std::string& serialized)
             {
-                using namespace rapidjson;
+                WriteToString(serialized, 0, [&](auto& writer) {
+                    WriteJsonDelta(writer, previous, current);
+                });
+            }
 
-                // If possible, use the default instance of T. This makes partial deserialization
-                // much more intuitive. Otherwise an unitialized instance is used.
-                T value;
-                if constexpr (std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>)
+            /// Applies a delta written by SerializeDelta, patching the value in
+            /// place.
+            /// @remarks The value must equal the previous value that the delta
+            /// was serialized from, after which it equals the current value.
+            /// @tparam T the type of the value.
+            /// @param delta The serialized delta.
+            /// @param target The value to patch.
+            template <typename T>
+            void ApplyDelta(std::string_view delta, T& target)
+            {
+                // The document is reused, clearing its memory pool each time
+                // as values released by a parse are not otherwise reclaimed.
+                auto& document = GetState().deltaDocument;
+                document.GetAllocator().Clear();
+                document.template Parse<JsonParseFlags>(delta.data(), delta.size());
+                if (document.HasParseError())
                 {
-                    value = T{};
+                    ThrowParseError(document, "JSON delta");
                 }
 
-                Document document;
+                ApplyJsonDelta(document, target);
+            }
+
+        private:
+            template <typename TStream>
+            using Writer = JsonWriter<std::conditional_t<
+                TPolicy::pretty,
+                rapidjson::PrettyWriter<TStream>,
+                rapidjson::Writer<TStream>
+            >>;
+
+            struct State final
+            {
+                Writer<StringWriteStream> writer;
+                rapidjson::Reader reader;
+                JsonReadContext context{TPolicy::propertiesRequired};
+                rapidjson::Document deltaDocument;
+                std::unique_ptr<char[]> streamBuffer;
+            };
+
+            JsonNumberFormat _numberFormat;
+            int _maxDecimalPlaces;
+            std::unique_ptr<State> _state;
+
+            State& GetState()
+            {
+                if (!_state)
+                {
+                    _state = std::make_unique<State>();
+                }
+
+                return *_state;
+            }
+
+            struct FileCloser final
+            {
+                void operator()(std::FILE* file) const
+                {
+                    std::fclose(file);
+                }
+            };
+
+            static std::unique_ptr<std::FILE, FileCloser> OpenFile(std::filesystem::path const& path, char const* mode)
+            {
+                std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.string().c_str(), mode));
+                if (!file)
+                {
+                    throw OpCoSerializerException("Unable to open file - " + path.string());
+                }
+
+                return file;
+            }
+
+            char* GetStreamBuffer()
+            {
+                auto& state = GetState();
+                if (!state.streamBuffer)
+                {
+                    state.streamBuffer = std::make_unique<char[]>(JsonStreamBufferSize);
+                }
+
+                return state.streamBuffer.get();
+            }
+
+            template <typename TStream, typename T>
+            void WriteTo(TStream& stream, T const& value)
+            {
+                Writer<TStream> writer(stream);
+                writer.SetNumberFormat(_numberFormat, _maxDecimalPlaces);
+                WriteJson(writer, value);
+                stream.Flush();
+            }
+
+            template <typename T, unsigned ParseFlags = JsonParseFlags, typename TStream>
+            T ReadFrom(TStream& stream)
+            {
+                // Types without a default constructor are built once from their
+                // properties. Otherwise the default instance of T is read into,
+                // which makes partial deserialization much more intuitive.
+                if constexpr (IsConstructedFromPropertiesV<T>)
+                {
+                    std::optional<T> value;
+                    Parse<ParseFlags>(stream, [&](JsonReadContext& context) { context.ExpectConstructed(value); });
+                    return std::move(*value);
+                }
+                else
+                {
+                    T value{};
+                    Read<ParseFlags>(stream, value);
+                    return value;
+                }
+            }
+
+            // The JSON is written straight into the string, which is left
+            // empty if writing fails part way through.
+            template <typename TWrite>
+            void WriteToString(std::string& serialized, std::size_t sizeBound, TWrite&& write)
+            {
+                auto& state = GetState();
+                StringWriteStream stream(serialized, sizeBound);
                 try
                 {
-                    document.Parse(serializedString.c_str());
+                    state.writer.Reset(stream);
+                    state.writer.SetNumberFormat(_numberFormat, _maxDecimalPlaces);
+                    write(state.writer);
                 }
-                catch (std::runtime_error& exception)
+                catch (...)
                 {
-                    auto message = std::string("Error whilst parsing JSON document from string - ") + std::string(exception.what());
-                    throw OpCoSerializerException(message);
+                    serialized.clear();
+                    throw;
                 }
 
-                ForProperty<T>([&](auto& property) {
-                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
-                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
-                    auto iterator = document.FindMember(property.name);
-                    if (iterator == document.MemberEnd() && _settings.propertiesRequired)
-                    {
-                        throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
-                    }
+                stream.Finish();
+            }
 
-                    value.*(property.member) = JsonTypeSerializer<Type>::Deserialize(iterator->value);
-                });
+            // Values are read straight into their members as the parser
+            // produces tokens, so the document never exists in memory.
+            template <unsigned ParseFlags = JsonParseFlags, typename TStream, typename T>
+            void Read(TStream& stream, T& value)
+            {
+                Parse<ParseFlags>(stream, [&](JsonReadContext& context) { context.Expect(value); });
+            }
+
+            template <unsigned ParseFlags, typename TStream, typename TExpect>
+            void Parse(TStream& stream, TExpect&& expect)
+            {
+                auto& state = GetState();
+                state.context.Reset();
+                state.context.SetInput(stream);
+
+                expect(state.context);
 
-                return value;
+                auto result = state.reader.template Parse<ParseFlags>(stream, state.context);
+                if (result.IsError())
+                {
+                    ThrowParseError(result, "JSON document");
+                }
+            }
+    };
+
+    /// Serializes objects to and from JSON, with settings chosen at runtime.
+    /// @remarks Forwards each call to the BasicJsonSerializer for its
+    /// settings. Use BasicJsonSerializer directly when the settings are known
+    /// at compile time, so only the code for them is compiled.
+    /// As a BasicJsonSerializer, a JsonSerializer must not be used from
+    /// multiple threads at once.
+    class JsonSerializer final
+    {
+        public:
+            /// Initializes a new instance of the JsonSerializer type.
+            /// @param settings The settings.
+            explicit JsonSerializer(JsonSerializerSettings&& settings = JsonSerializerSettings())
+                : _serializer(Make(settings))
+            {
+            }
+
+            /// See BasicJsonSerializer::Serialize.
+            template <typename T>
+            std::string Serialize(T const& value)
+            {
+                return Visit([&](auto& serializer) { return serializer.Serialize(value); });
+            }
+
+            /// See BasicJsonSerializer::Serialize.
+            template <typename T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                Visit([&](auto& serializer) { serializer.Serialize(value, serialized); });
+            }
+
+            /// See BasicJsonSerializer::Serialize.
+            template <typename T>
+            void Serialize(T const& value, std::FILE* file)
+            {
+                Visit([&](auto& serializer) { serializer.Serialize(value, file); });
+            }
+
+            /// See BasicJsonSerializer::Serialize.
+            template <typename T>
+            void Serialize(T const& value, std::ostream& output)
+            {
+                Visit([&](auto& serializer) { serializer.Serialize(value, output); });
+            }
+
+            /// See BasicJsonSerializer::SerializeToFile.
+            template <typename T>
+            void SerializeToFile(T const& value, std::filesystem::path const& path)
+            {
+                Visit([&](auto& serializer) { serializer.SerializeToFile(value, path); });
+            }
+
+            /// See BasicJsonSerializer::Deserialize.
+            template <typename T>
+            T Deserialize(std::string_view serializedString)
+            {
+                return Visit([&](auto& serializer) { return serializer.template Deserialize<T>(serializedString); });
+            }
+
+            /// See BasicJsonSerializer::Deserialize.
+            template <typename T>
+            T Deserialize(char const* serialized, std::size_t length)
+            {
+                return Deserialize<T>(std::string_view(serialized, length));
+            }
+
+            /// See BasicJsonSerializer::DeserializeInto.
+            template <typename T>
+            void DeserializeInto(std::string_view serializedString, T& target)
+            {
+                Visit([&](auto& serializer) { serializer.DeserializeInto(serializedString, target); });
+            }
+
+            /// See BasicJsonSerializer::DeserializeInsitu.
+            template <typename T>
+            T DeserializeInsitu(std::span<char> buffer)
+            {
+                return Visit([&](auto& serializer) { return serializer.template DeserializeInsitu<T>(buffer); });
+            }
+
+            /// See BasicJsonSerializer::Deserialize.
+            template <typename T>
+            T Deserialize(std::FILE* file)
+            {
+                return Visit([&](auto& serializer) { return serializer.template Deserialize<T>(file); });
+            }
+
+            /// See BasicJsonSerializer::Deserialize.
+            template <typename T>
+            T Deserialize(std::istream& input)
+            {
+                return Visit([&](auto& serializer) { return serializer.template Deserialize<T>(input); });
+            }
+
+            /// See BasicJsonSerializer::DeserializeFromFile.
+            template <typename T>
+            T DeserializeFromFile(std::filesystem::path const& path)
+            {
+                return Visit([&](auto& serializer) { return serializer.template DeserializeFromFile<T>(path); });
+            }
+
+            /// See BasicJsonSerializer::SerializeDelta.
+            template <typename T>
+            std::string SerializeDelta(T const& previous, T const& current)
+            {
+                return Visit([&](auto& serializer) { return serializer.SerializeDelta(previous, current); });
+            }
+
+            /// See BasicJsonSerializer::SerializeDelta.
+            template <typename T>
+            void SerializeDelta(T const& previous, T const& current, std::string& serialized)
+            {
+                Visit([&](auto& serializer) { serializer.SerializeDelta(previous, current, serialized); });
+            }
+
+            /// See BasicJsonSerializer::ApplyDelta.
+            template <typename T>
+            void ApplyDelta(std::string_view delta, T& target)
+            {
+                Visit([&](auto& serializer) { serializer.ApplyDelta(delta, target); });
             }
 
         private:
-            JsonSerializerSettings _settings;
+            using Serializer = std::variant<
+                BasicJsonSerializer<JsonSerializerPolicy<false, false>>,
+                BasicJsonSerializer<JsonSerializerPolicy<false, true>>,
+                BasicJsonSerializer<JsonSerializerPolicy<true, false>>,
+                BasicJsonSerializer<JsonSerializerPolicy<true, true>>
+            >;
+
+            Serializer _serializer;
+
+            static Serializer Make(JsonSerializerSettings const& settings)
+            {
+                auto numberFormat = settings.numberFormat;
+                auto maxDecimalPlaces = settings.maxDecimalPlaces;
+                if (settings.pretty)
+                {
+                    return settings.propertiesRequired
+                        ? Serializer(std::in_place_index<3>, numberFormat, maxDecimalPlaces)
+                        : Serializer(std::in_place_index<2>, numberFormat, maxDecimalPlaces);
+                }
+
+                return settings.propertiesRequired
+                    ? Serializer(std::in_place_index<1>, numberFormat, maxDecimalPlaces)
+                    : Serializer(std::in_place_index<0>, numberFormat, maxDecimalPlaces);
+            }
 
-            template <typename TWriter>
-            std::string StringifyDocument(rapidjson::Document& document)
+            template <typename F>
+            decltype(auto) Visit(F&& f)
             {
-                rapidjson::StringBuffer buffer;
-                TWriter writer(buffer);
-                document.Accept(writer);
-                return buffer.GetString();
+                return std::visit(std::forward<F>(f), _serializer);
             }
     };
 }
@@ -21,6 +21,8 @@
 #ifndef OPCOSERIALIZER_JSON_SERIALIZER_SETTINGS_HPP
 #define OPCOSERIALIZER_JSON_SERIALIZER_SETTINGS_HPP
 
+#include "OpCoSerializer/Json/JsonNumberFormat.hpp"
+
 namespace OpCoSerializer::Json
 {
     /// Configuration for a JsonSerializer.
@@ -32,6 +34,30 @@ namespace OpCoSerializer::Json
 
         /// Whether or not to serialize JSON to a prettier indented string.
         bool pretty = false;
+
+        /// How floating point values are written. Properties can override
+        /// it through WithNumberFormat.
+        JsonNumberFormat numberFormat = JsonNumberFormat::Shortest;
+
+        /// The maximum number of decimal places for JsonNumberFormat::Fixed.
+        int maxDecimalPlaces = JsonDefaultMaxDecimalPlaces;
+    };
+
+    /// Configuration for a BasicJsonSerializer, fixed at compile time.
+    /// @remarks A custom policy can be any type with the same static members.
+    /// @tparam Pretty Whether or not to serialize JSON to a prettier indented
+    /// string.
+    /// @tparam PropertiesRequired Indicates when deserializing, if a member is
+    /// not present, whether or not an exception should be thrown.
+    template <bool Pretty = false, bool PropertiesRequired = false>
+    struct JsonSerializerPolicy final
+    {
+        /// Whether or not to serialize JSON to a prettier indented string.
+        static constexpr bool pretty = Pretty;
+
+        /// Indicates when deserializing, if a member is not present, whether
+        /// or not an exception should be thrown.
+        static constexpr bool propertiesRequired = PropertiesRequired;
     };
 }
 
@@ -0,0 +1,474 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_STREAMS_HPP
+#define OPCOSERIALIZER_JSON_STREAMS_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/writer.h"
+
+namespace OpCoSerializer::Json
+{
+    /// The size of the fixed buffers used when streaming to and from files
+    /// and standard streams.
+    std::size_t constexpr JsonStreamBufferSize = 64 * 1024;
+
+    /// A rapidjson output stream which writes to a std::ostream through a
+    /// fixed size buffer.
+    /// @remarks rapidjson::OStreamWrapper writes each character to the
+    /// std::ostream individually, whereas this writes a block at a time.
+    class OStreamWriteStream final
+    {
+        public:
+            using Ch = char;
+
+            /// Initializes a new instance of the OStreamWriteStream type.
+            /// @param stream The stream to write to.
+            /// @param buffer The buffer.
+            /// @param bufferSize The size of the buffer.
+            OStreamWriteStream(std::ostream& stream, char* buffer, std::size_t bufferSize)
+                : _stream(stream),
+                  _buffer(buffer),
+                  _bufferEnd(buffer + bufferSize),
+                  _current(buffer)
+            {
+            }
+
+            OStreamWriteStream(OStreamWriteStream const&) = delete;
+            OStreamWriteStream& operator=(OStreamWriteStream const&) = delete;
+
+            void Put(char c)
+            {
+                if (_current == _bufferEnd)
+                {
+                    Flush();
+                }
+
+                *_current++ = c;
+            }
+
+            /// Writes the buffered characters to the stream.
+            void Flush()
+            {
+                if (_current != _buffer)
+                {
+                    _stream.write(_buffer, _current - _buffer);
+                    _current = _buffer;
+                }
+            }
+
+            // Not implemented.
+            char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
+            char Take() { RAPIDJSON_ASSERT(false); return 0; }
+            std::size_t Tell() const { RAPIDJSON_ASSERT(false); return 0; }
+            char* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+            std::size_t PutEnd(char*) { RAPIDJSON_ASSERT(false); return 0; }
+
+        private:
+            std::ostream& _stream;
+            char* _buffer;
+            char* _bufferEnd;
+            char* _current;
+    };
+
+    /// A rapidjson output stream which writes straight into a std::string,
+    /// replacing its contents.
+    /// @remarks The string is sized up front, e.g. to SerializedSizeBound, so
+    /// the JSON is written with no regrowth and no final copy. It grows if more
+    /// room is needed. Finish trims it to the written length. Like
+    /// rapidjson::StringBuffer, writers reserve room once per value through
+    /// PutReserve and then write each character unchecked.
+    class StringWriteStream final
+    {
+        public:
+            using Ch = char;
+
+            /// Initializes a new instance of the StringWriteStream type.
+            /// @param output The string to write to.
+            /// @param sizeBound The expected maximum length of the output.
+            /// @remarks Only the bound is sized, not the string's whole
+            /// capacity, so reusing a large string costs no more than a small
+            /// one.
+            StringWriteStream(std::string& output, std::size_t sizeBound)
+                : _output(output)
+            {
+                _output.resize(sizeBound);
+                _current = _output.data();
+                _end = _current + _output.size();
+            }
+
+            StringWriteStream(StringWriteStream const&) = delete;
+            StringWriteStream& operator=(StringWriteStream const&) = delete;
+
+            void Put(char c)
+            {
+                if (_current == _end)
+                {
+                    Grow(1);
+                }
+
+                *_current++ = c;
+            }
+
+            /// Ensures there is room for the given number of characters, which
+            /// can then be written with PutUnsafe.
+            /// @param count The number of characters.
+            void Reserve(std::size_t count)
+            {
+                if (static_cast<std::size_t>(_end - _current) < count)
+                {
+                    Grow(count);
+                }
+            }
+
+            /// Writes a character without checking for room.
+            /// @param c The character.
+            void PutUnsafe(char c)
+            {
+                *_current++ = c;
+            }
+
+            /// Ensures there is room for the given number of characters and
+            /// returns where to write them, for the writer's number formatting.
+            /// @param count The number of characters.
+            /// @returns The first character.
+            char* Push(std::size_t count)
+            {
+                Reserve(count);
+                auto begin = _current;
+                _current += count;
+                return begin;
+            }
+
+            /// Gives back characters from the end of a Push which were not
+            /// written.
+            /// @param count The number of characters.
+            void Pop(std::size_t count)
+            {
+                _current -= count;
+            }
+
+            void Flush()
+            {
+            }
+
+            /// Trims the string to the characters written.
+            void Finish()
+            {
+                _output.resize(static_cast<std::size_t>(_current - _output.data()));
+            }
+
+            // Not implemented.
+            char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
+            char Take() { RAPIDJSON_ASSERT(false); return 0; }
+            std::size_t Tell() const { RAPIDJSON_ASSERT(false); return 0; }
+            char* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+            std::size_t PutEnd(char*) { RAPIDJSON_ASSERT(false); return 0; }
+
+        private:
+            std::string& _output;
+            char* _current;
+            char* _end;
+
+            void Grow(std::size_t count)
+            {
+                auto written = static_cast<std::size_t>(_current - _output.data());
+                _output.resize(std::max(_output.size() * 2, written + count));
+                _current = _output.data() + written;
+                _end = _output.data() + _output.size();
+            }
+    };
+
+    /// Gets the number of characters a rapidjson writer writes for the given
+    /// character of a string: 2 for a short escape such as \n, 6 for \u00XX
+    /// and 1 otherwise.
+    /// @param c The character.
+    /// @returns The number of characters.
+    constexpr std::size_t JsonEscapedLength(char c)
+    {
+        auto u = static_cast<unsigned char>(c);
+        if (u < 0x20)
+        {
+            return c == '\b' || c == '\t' || c == '\n' || c == '\f' || c == '\r' ? 2 : 6;
+        }
+
+        return c == '"' || c == '\\' ? 2 : 1;
+    }
+
+    /// Gets the number of characters a rapidjson writer writes for the given
+    /// string.
+    /// @param value The string.
+    /// @returns The number of characters, including the quotes.
+    constexpr std::size_t JsonEscapedLength(std::string_view value)
+    {
+        std::size_t length = 2;
+        for (auto c : value)
+        {
+            length += JsonEscapedLength(c);
+        }
+
+        return length;
+    }
+
+    /// Reserves room in a StringWriteStream for rapidjson writers.
+    inline void PutReserve(StringWriteStream& stream, std::size_t count)
+    {
+        stream.Reserve(count);
+    }
+
+    /// Writes a character to a StringWriteStream after PutReserve.
+    inline void PutUnsafe(StringWriteStream& stream, char c)
+    {
+        stream.PutUnsafe(c);
+    }
+}
+
+// Like rapidjson's own specializations for StringBuffer, numbers are
+// formatted straight into a StringWriteStream rather than through a
+// temporary buffer, and raw values such as JsonKeys are copied in one step.
+// Strings take exactly the room they need rather than six characters for
+// each one, so the stream does not grow past a tight size bound.
+namespace rapidjson
+{
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteString(const Ch* str, SizeType length)
+    {
+        static char const hexDigits[] = "0123456789ABCDEF";
+        std::string_view value(str, length);
+        char* buffer = os_->Push(OpCoSerializer::Json::JsonEscapedLength(value));
+        *buffer++ = '"';
+        for (auto c : value)
+        {
+            if (OpCoSerializer::Json::JsonEscapedLength(c) == 1)
+            {
+                *buffer++ = c;
+                continue;
+            }
+
+            *buffer++ = '\\';
+            switch (c)
+            {
+                case '"': *buffer++ = '"'; break;
+                case '\\': *buffer++ = '\\'; break;
+                case '\b': *buffer++ = 'b'; break;
+                case '\t': *buffer++ = 't'; break;
+                case '\n': *buffer++ = 'n'; break;
+                case '\f': *buffer++ = 'f'; break;
+                case '\r': *buffer++ = 'r'; break;
+                default:
+                    *buffer++ = 'u';
+                    *buffer++ = '0';
+                    *buffer++ = '0';
+                    *buffer++ = hexDigits[static_cast<unsigned char>(c) >> 4];
+                    *buffer++ = hexDigits[static_cast<unsigned char>(c) & 0xF];
+                    break;
+            }
+        }
+
+        *buffer = '"';
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteInt(int i)
+    {
+        char* buffer = os_->Push(11);
+        const char* end = internal::i32toa(i, buffer);
+        os_->Pop(static_cast<std::size_t>(11 - (end - buffer)));
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteUint(unsigned u)
+    {
+        char* buffer = os_->Push(10);
+        const char* end = internal::u32toa(u, buffer);
+        os_->Pop(static_cast<std::size_t>(10 - (end - buffer)));
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteInt64(int64_t i64)
+    {
+        char* buffer = os_->Push(21);
+        const char* end = internal::i64toa(i64, buffer);
+        os_->Pop(static_cast<std::size_t>(21 - (end - buffer)));
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteUint64(uint64_t u)
+    {
+        char* buffer = os_->Push(20);
+        const char* end = internal::u64toa(u, buffer);
+        os_->Pop(static_cast<std::size_t>(20 - (end - buffer)));
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteDouble(double d)
+    {
+        if (internal::Double(d).IsNanOrInf())
+        {
+            // NaN and infinity are rejected, as by the default writer flags.
+            return false;
+        }
+
+        char* buffer = os_->Push(25);
+        char* end = internal::dtoa(d, buffer, maxDecimalPlaces_);
+        os_->Pop(static_cast<std::size_t>(25 - (end - buffer)));
+        return true;
+    }
+
+    template <>
+    inline bool Writer<OpCoSerializer::Json::StringWriteStream>::WriteRawValue(const Ch* json, size_t length)
+    {
+        std::memcpy(os_->Push(length), json, length);
+        return true;
+    }
+}
+
+namespace OpCoSerializer::Json
+{
+
+    /// A rapidjson input stream which reads from a std::istream through a
+    /// fixed size buffer.
+    /// @remarks rapidjson::IStreamWrapper reads each character from the
+    /// std::istream individually, whereas this reads a block at a time.
+    class IStreamReadStream final
+    {
+        public:
+            using Ch = char;
+
+            /// Initializes a new instance of the IStreamReadStream type.
+            /// @param stream The stream to read from.
+            /// @param buffer The buffer.
+            /// @param bufferSize The size of the buffer. Must be at least 4 bytes.
+            IStreamReadStream(std::istream& stream, char* buffer, std::size_t bufferSize)
+                : _stream(stream),
+                  _buffer(buffer),
+                  _bufferSize(bufferSize),
+                  _bufferLast(nullptr),
+                  _current(buffer),
+                  _readCount(0),
+                  _count(0),
+                  _eof(false)
+            {
+                RAPIDJSON_ASSERT(bufferSize >= 4);
+                Read();
+            }
+
+            IStreamReadStream(IStreamReadStream const&) = delete;
+            IStreamReadStream& operator=(IStreamReadStream const&) = delete;
+
+            Ch Peek() const { return *_current; }
+            Ch Take() { Ch c = *_current; Read(); return c; }
+            std::size_t Tell() const { return _count + static_cast<std::size_t>(_current - _buffer); }
+
+            // Not implemented.
+            void Put(Ch) { RAPIDJSON_ASSERT(false); }
+            void Flush() { RAPIDJSON_ASSERT(false); }
+            Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+            std::size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+
+        private:
+            std::istream& _stream;
+            Ch* _buffer;
+            std::size_t _bufferSize;
+            Ch* _bufferLast;
+            Ch* _current;
+            std::size_t _readCount;
+            std::size_t _count;
+            bool _eof;
+
+            void Read()
+            {
+                if (_current < _bufferLast)
+                {
+                    ++_current;
+                }
+                else if (!_eof)
+                {
+                    _count += _readCount;
+                    _stream.read(_buffer, static_cast<std::streamsize>(_bufferSize));
+                    _readCount = static_cast<std::size_t>(_stream.gcount());
+                    _bufferLast = _buffer + _readCount - 1;
+                    _current = _buffer;
+
+                    // A short read marks the end of the stream, which the
+                    // parser sees as a null character.
+                    if (_readCount < _bufferSize)
+                    {
+                        _buffer[_readCount] = '\0';
+                        ++_bufferLast;
+                        _eof = true;
+                    }
+                }
+            }
+    };
+
+    /// A rapidjson input stream for parsing in situ, which reads from and
+    /// writes decoded strings back into a buffer of known length.
+    /// @remarks rapidjson::InsituStringStream requires a null terminated
+    /// buffer, whereas this ends at the end of the buffer.
+    class InsituMemoryStream final
+    {
+        public:
+            using Ch = char;
+
+            /// Initializes a new instance of the InsituMemoryStream type.
+            /// @param buffer The buffer, which is overwritten while parsing.
+            /// @param size The size of the buffer.
+            InsituMemoryStream(char* buffer, std::size_t size)
+                : _begin(buffer),
+                  _end(buffer + size),
+                  _source(buffer),
+                  _destination(nullptr)
+            {
+            }
+
+            Ch Peek() const { return _source == _end ? '\0' : *_source; }
+            Ch Take() { return _source == _end ? '\0' : *_source++; }
+            std::size_t Tell() const { return static_cast<std::size_t>(_source - _begin); }
+
+            // Decoded strings are never longer than their encoded form, so
+            // they are written behind the read position.
+            Ch* PutBegin() { return _destination = _source; }
+            void Put(Ch c) { RAPIDJSON_ASSERT(_destination != nullptr); *_destination++ = c; }
+            std::size_t PutEnd(Ch* begin) { return static_cast<std::size_t>(_destination - begin); }
+
+            // Not implemented.
+            void Flush() { RAPIDJSON_ASSERT(false); }
+
+        private:
+            Ch* _begin;
+            Ch* _end;
+            Ch* _source;
+            Ch* _destination;
+    };
+}
+
+#endif // OPCOSERIALIZER_JSON_STREAMS_HPP
@@ -23,6 +23,171 @@
 
 namespace OpCoSerializer::Json
 {
+    template <typename T>
+    struct JsonTypeSerializer;
+
+    /// Writes the given value directly to a rapidjson writer.
+    /// @remarks If the JsonTypeSerializer<T> specialization does not provide
+    /// a Write function, the value is serialized through its DOM based
+    /// Serialize function and the resulting JSON value is written instead.
+    /// @tparam T The type of the value.
+    /// @param writer The writer (e.g. a rapidjson::Writer or rapidjson::PrettyWriter).
+    /// @param value The value.
+    template <typename T, typename TWriter>
+    void WriteJson(TWriter& writer, T const& value)
+    {
+        if constexpr (requires { JsonTypeSerializer<T>::Write(writer, value); })
+        {
+            JsonTypeSerializer<T>::Write(writer, value);
+        }
+        else
+        {
+            rapidjson::Document document;
+            JsonTypeSerializer<T>::Serialize(document, value).Accept(writer);
+        }
+    }
+
+    /// Reads the value starting with the given token.
+    /// @remarks If the JsonTypeSerializer<T> specialization does not provide
+    /// a Read function, the value is read into a rapidjson document and
+    /// deserialized through its DOM based Deserialize function instead.
+    /// @tparam T The type of the value.
+    /// @param context The read context.
+    /// @param value The value to read into.
+    /// @param token The first token of the value.
+    template <typename T>
+    void ReadJson(JsonReadContext& context, T& value, JsonToken const& token)
+    {
+        if constexpr (requires { JsonTypeSerializer<T>::Read(context, value, token); })
+        {
+            JsonTypeSerializer<T>::Read(context, value, token);
+        }
+        else
+        {
+            context.ReadThroughDocument(value, token);
+        }
+    }
+
+    /// Gets an upper bound on the length of the JSON written for any value of
+    /// T, or zero if the length depends on the value.
+    /// @remarks Provided by a constexpr FixedSizeBound function of the
+    /// JsonTypeSerializer<T> specialization, if it has one.
+    /// @tparam T The type of the value.
+    template <typename T>
+    constexpr std::size_t JsonFixedSizeBound()
+    {
+        if constexpr (requires { JsonTypeSerializer<T>::FixedSizeBound(); })
+        {
+            return JsonTypeSerializer<T>::FixedSizeBound();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /// Helper for the value of JsonFixedSizeBound<T>(), evaluated at compile
+    /// time.
+    template <typename T>
+    std::size_t constexpr JsonFixedSizeBoundV = JsonFixedSizeBound<T>();
+
+    /// Gets an upper bound on the length of the compact JSON written for the
+    /// given value, so that the output can be allocated once.
+    /// @remarks The bound is built from the property metadata: the length of
+    /// each name, the most characters each type of number can take, and the
+    /// lengths of strings and vectors. Names and strings count as the room the
+    /// writer reserves for them, so that writing never outgrows the bound.
+    /// Values whose JsonTypeSerializer<T> specialization has neither a
+    /// FixedSizeBound nor a SizeBound function count as zero, in which case
+    /// the bound is only an estimate.
+    /// @tparam T The type of the value.
+    /// @param value The value.
+    /// @returns The bound, in characters.
+    template <typename T>
+    std::size_t SerializedSizeBound(T const& value)
+    {
+        if constexpr (JsonFixedSizeBoundV<T> != 0)
+        {
+            return JsonFixedSizeBoundV<T>;
+        }
+        else if constexpr (requires { JsonTypeSerializer<T>::SizeBound(value); })
+        {
+            return JsonTypeSerializer<T>::SizeBound(value);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /// Gets the length of the braces or brackets and separators around a JSON
+    /// object or array with the given number of members or elements.
+    /// @param count The number of members or elements.
+    /// @returns The length.
+    constexpr std::size_t JsonContainerSizeBound(std::size_t count)
+    {
+        return 2 + (count > 0 ? count - 1 : 0);
+    }
+
+    /// Gets the length of the given string written to JSON, counting the
+    /// characters which need escaping.
+    /// @param value The string.
+    /// @returns The length, including the quotes.
+    constexpr std::size_t JsonStringSizeBound(std::string_view value)
+    {
+        return JsonEscapedLength(value);
+    }
+
+    /// Gets the length of a property key written through JsonKeys<T>, which
+    /// needs no escaping, and its separator.
+    /// @param nameLength The length of the property name.
+    /// @returns The length, including the quotes and colon.
+    constexpr std::size_t JsonKeySizeBound(std::size_t nameLength)
+    {
+        return nameLength + 3;
+    }
+
+    /// Writes an arithmetic value with the matching rapidjson writer event.
+    /// @param writer The writer.
+    /// @param value The value.
+    template <typename TWriter, typename T>
+    void WriteJsonNumber(TWriter& writer, T value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            writer.Bool(value);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            if (!writer.Double(static_cast<double>(value)))
+            {
+                throw OpCoSerializerException("Unable to write a non-finite floating point value to JSON");
+            }
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            if constexpr (sizeof(T) <= sizeof(int32_t))
+            {
+                writer.Int(static_cast<int32_t>(value));
+            }
+            else
+            {
+                writer.Int64(static_cast<int64_t>(value));
+            }
+        }
+        else
+        {
+            if constexpr (sizeof(T) <= sizeof(uint32_t))
+            {
+                writer.Uint(static_cast<uint32_t>(value));
+            }
+            else
+            {
+                writer.Uint64(static_cast<uint64_t>(value));
+            }
+        }
+    }
+
     /// Provides Json serialization and serialization logic for a type.
     /// @remarks Specialize this type in order to be able serialize or
     /// deserialize any type of data. By default, this type will support:
@@ -44,7 +209,7 @@ namespace OpCoSerializer::Json
         /// is also available.
         /// @param document The document.
         /// @param value The value.
-        static rapidjson::Value Serialize(rapidjson::Document& document, T& value)
+        static rapidjson::Value Serialize(rapidjson::Document& document, T const& value)
         {
             if constexpr (HasSerializablePropertiesV<T>)
             {
@@ -54,11 +219,11 @@ namespace OpCoSerializer::Json
                 ForProperty<T>([&](auto& property) {
                     using PropertyType = typename std::remove_cvref<decltype(property)>::type;
                     using Type = std::remove_cvref<typename PropertyType::Type>::type;
-                    auto propertyValue = value.*(property.member);
-                    auto key = std::string(property.name);
+                    // Property names are string literals, so the key can
+                    // reference the name rather than copying it.
                     object.AddMember(
-                        rapidjson::Value(key.c_str(), key.size(), document.GetAllocator()),
-                        JsonTypeSerializer<Type>::Serialize(document, propertyValue),
+                        rapidjson::Value(rapidjson::StringRef(property.name, property.nameLength)),
+                        JsonTypeSerializer<Type>::Serialize(document, value.*(property.member)),
                         document.GetAllocator()
                     );
                 });
@@ -75,30 +240,233 @@ namespace OpCoSerializer::Json
             }
         }
 
+        /// Gets an upper bound on the length of the JSON written for any value
+        /// of T, or zero if it depends on the value, e.g. for types with string
+        /// or vector properties.
+        static constexpr std::size_t FixedSizeBound()
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                auto bound = JsonContainerSizeBound(PropertyCountV<T>);
+                bool fixed = true;
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    fixed = fixed && JsonFixedSizeBoundV<Type> != 0;
+                    bound += JsonKeySizeBound(property.nameLength) + JsonFixedSizeBoundV<Type>;
+                });
+
+                return fixed ? bound : 0;
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                return std::numeric_limits<int32_t>::digits10 + 2;
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return 5;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                // The longest JsonNumberFormat::HexFloat string, e.g.
+                // "-0x1.fffffffffffffp-1022", which is longer than the buffer
+                // rapidjson formats doubles into.
+                return 26;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                return std::numeric_limits<T>::digits10 + (std::is_signed_v<T> ? 2 : 1);
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        /// Gets an upper bound on the length of the JSON written for the
+        /// given value.
+        /// @param value The value.
+        static std::size_t SizeBound(T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                auto bound = JsonContainerSizeBound(PropertyCountV<T>);
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    bound += JsonKeySizeBound(property.nameLength) + SerializedSizeBound<Type>(value.*(property.member));
+                });
+
+                return bound;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        /// Writes the given value directly to a rapidjson writer, without
+        /// building an intermediate document.
+        /// @param writer The writer.
+        /// @param value The value.
+        template <typename TWriter>
+        static void Write(TWriter& writer, T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                writer.StartObject();
+
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    JsonKeys<T>::Write(writer, index++);
+                    WriteWithNumberFormat(writer, property, [&] {
+                        WriteJson<Type>(writer, value.*(property.member));
+                    });
+                });
+
+                writer.EndObject();
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                writer.Int(static_cast<int32_t>(value));
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                WriteJsonNumber(writer, value);
+            }
+            else
+            {
+                rapidjson::Document document;
+                Serialize(document, value).Accept(writer);
+            }
+        }
+
+        /// Reads a value as tokens arrive from the parser, without building
+        /// a document.
+        /// @remarks Objects push a frame onto the context which then receives
+        /// the tokens of each member.
+        /// @param context The read context.
+        /// @param value The value to read into.
+        /// @param token The first token of the value.
+        static void Read(JsonReadContext& context, T& value, JsonToken const& token)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                if (token.type != JsonTokenType::StartObject)
+                {
+                    token.ThrowUnexpected("an object");
+                }
+
+                context.Push(&ReadMember, &value, PropertyCountV<T>);
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                value = static_cast<T>(token.GetNumber<int32_t>());
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                value = token.GetNumber<T>();
+            }
+            else
+            {
+                context.ReadThroughDocument(value, token);
+            }
+        }
+
+        /// Reads a value which is constructed from the values of its
+        /// properties, for types without a default constructor.
+        /// @remarks The property values are gathered as they are read and T is
+        /// constructed once the object ends, then passed to deliver.
+        /// @param context The read context.
+        /// @param token The first token of the value.
+        /// @param destination Passed to deliver.
+        /// @param deliver Receives the constructed value.
+        static void Construct(JsonReadContext& context, JsonToken const& token, void* destination, void (*deliver)(void* destination, T&& value))
+        {
+            static_assert(HasSerializablePropertiesV<T>, "Only types with serializable properties can be constructed from them");
+
+            if (token.type != JsonTokenType::StartObject)
+            {
+                token.ThrowUnexpected("an object");
+            }
+
+            auto builder = std::make_unique<Builder>(destination, deliver);
+            context.Push(&ReadConstructedMember, builder.get(), PropertyCountV<T>, &ReleaseBuilder);
+            builder.release();
+        }
+
         /// Deserializes a value from the given JSON value.
         /// @param value The value.
         /// @returns The deserialized value.
         static T Deserialize(rapidjson::Value& value)
         {
-            if constexpr (HasSerializablePropertiesV<T>)
+            if constexpr (IsConstructedFromPropertiesV<T>)
             {
-                T deserialized;
-                if constexpr (std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>)
+                if (!value.IsObject())
                 {
-                    deserialized = T{};
+                    throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an object");
                 }
 
-                ForProperty<T>([&](auto& property) {
-                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
-                    using Type = std::remove_cvref<typename PropertyType::Type>::type;
-                    auto iterator = value.FindMember(property.name);
-                    if (iterator == value.MemberEnd())
+                // The property values are gathered first, then T is built once
+                // from them.
+                PropertyValuesT<T> values;
+                for (auto& member : value.GetObject())
+                {
+                    auto index = PropertyLookup<T>::Find(member.name.GetString(), member.name.GetStringLength());
+                    if (index == PropertyLookup<T>::npos)
                     {
-                        throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                        continue;
                     }
 
-                    deserialized.*(property.member) = JsonTypeSerializer<Type>::Deserialize(iterator->value);
-                });
+                    ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                        auto& propertyValue = std::get<i>(values);
+                        using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                        propertyValue.emplace(JsonTypeSerializer<Type>::Deserialize(member.value));
+                    });
+                }
+
+                return ConstructFromProperties<T>(values, true);
+            }
+            else if constexpr (HasSerializablePropertiesV<T>)
+            {
+                T deserialized{};
+
+                if (!value.IsObject())
+                {
+                    throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an object");
+                }
+
+                // A single pass over the members, looking up each name in the
+                // property table rather than searching for each property.
+                std::bitset<PropertyCountV<T>> seen;
+                for (auto& member : value.GetObject())
+                {
+                    auto index = PropertyLookup<T>::Find(member.name.GetString(), member.name.GetStringLength());
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        continue;
+                    }
+
+                    seen.set(index);
+                    ForPropertyAt<T>(index, [&](auto& property) {
+                        using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                        using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                        deserialized.*(property.member) = JsonTypeSerializer<Type>::Deserialize(member.value);
+                    });
+                }
+
+                if (!seen.all())
+                {
+                    std::size_t index = 0;
+                    ForProperty<T>([&](auto& property) {
+                        if (!seen.test(index++))
+                        {
+                            throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                        }
+                    });
+                }
 
                 return deserialized;
             }
@@ -106,11 +474,123 @@ namespace OpCoSerializer::Json
             {
                 return static_cast<T>(value.Get<int32_t>());
             }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                double parsed;
+                if (value.IsString() && ParseJsonHexFloat(value.GetString(), value.GetStringLength(), parsed))
+                {
+                    return static_cast<T>(parsed);
+                }
+
+                return value.Get<T>();
+            }
             else
             {
                 return value.Get<T>();
             }
         }
+
+        private:
+            struct Builder final
+            {
+                PropertyValuesT<T> values;
+                void* destination;
+                void (*deliver)(void* destination, T&& value);
+
+                Builder(void* destination, void (*deliver)(void* destination, T&& value))
+                    : destination(destination),
+                      deliver(deliver)
+                {
+                }
+            };
+
+            static void ReleaseBuilder(void* builder)
+            {
+                delete static_cast<Builder*>(builder);
+            }
+
+            static void ReadConstructedMember(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                auto& builder = *static_cast<Builder*>(frame.target);
+
+                if (token.type == JsonTokenType::Key)
+                {
+                    auto index = PropertyLookup<T>::Find(token.string, token.length);
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        context.Skip();
+                        return;
+                    }
+
+                    ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                        auto& propertyValue = std::get<i>(builder.values);
+                        using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                        if constexpr (IsConstructedFromPropertiesV<Type>)
+                        {
+                            propertyValue.reset();
+                            context.ExpectConstructed(propertyValue);
+                        }
+                        else
+                        {
+                            if (!propertyValue)
+                            {
+                                propertyValue.emplace();
+                            }
+
+                            context.Expect(*propertyValue);
+                        }
+                    });
+                }
+                else if (token.type == JsonTokenType::EndObject)
+                {
+                    // Ownership of the builder moves from the frame to here.
+                    std::unique_ptr<Builder> owned(&builder);
+                    auto required = frame.required;
+                    frame.release = nullptr;
+                    context.Pop();
+
+                    owned->deliver(owned->destination, ConstructFromProperties<T>(owned->values, required));
+                }
+            }
+
+            static void ReadMember(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                auto& value = *static_cast<T*>(frame.target);
+
+                if (token.type == JsonTokenType::Key)
+                {
+                    auto index = PropertyLookup<T>::Find(token.string, token.length);
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        context.Skip();
+                        return;
+                    }
+
+                    if (frame.required)
+                    {
+                        context.MarkSeen(frame, index);
+                    }
+
+                    ForPropertyAt<T>(index, [&](auto& property) {
+                        context.Expect(value.*(property.member));
+                    });
+                }
+                else if (token.type == JsonTokenType::EndObject)
+                {
+                    if (frame.required)
+                    {
+                        std::size_t index = 0;
+                        ForProperty<T>([&](auto& property) {
+                            if (!context.Seen(frame, index++))
+                            {
+                                throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                            }
+                        });
+                    }
+
+                    context.Pop();
+                }
+            }
     };
 
     /// Partial JsonTypeSerializer specialization for a vector of a given type.
@@ -121,14 +601,15 @@ namespace OpCoSerializer::Json
     template <typename TElement>
     struct JsonTypeSerializer<std::vector<TElement>>
     {
-        static rapidjson::Value Serialize(rapidjson::Document& document, std::vector<TElement>& value)
+        static rapidjson::Value Serialize(rapidjson::Document& document, std::vector<TElement> const& value)
         {
             using namespace rapidjson;
             
             Value array;
             array.SetArray();
 
-            for (auto& element : value)
+            array.Reserve(static_cast<SizeType>(value.size()), document.GetAllocator());
+            for (auto const& element : value)
             {
                 array.PushBack(
                     JsonTypeSerializer<TElement>::Serialize(document, element),
@@ -139,36 +620,623 @@ namespace OpCoSerializer::Json
             return array;
         }
 
+        static std::size_t SizeBound(std::vector<TElement> const& value)
+        {
+            auto bound = JsonContainerSizeBound(value.size());
+            if constexpr (JsonFixedSizeBoundV<TElement> != 0)
+            {
+                return bound + value.size() * JsonFixedSizeBoundV<TElement>;
+            }
+            else
+            {
+                for (auto const& element : value)
+                {
+                    bound += SerializedSizeBound<TElement>(element);
+                }
+
+                return bound;
+            }
+        }
+
+        /// @remarks Numbers are formatted in bulk when the writer supports it
+        /// (see JsonWriter::WriteNumbers).
+        template <typename TWriter>
+        static void Write(TWriter& writer, std::vector<TElement> const& value)
+        {
+            writer.StartArray();
+
+            if constexpr (requires { writer.WriteNumbers(value.data(), value.size()); })
+            {
+                if (!writer.WriteNumbers(value.data(), value.size()))
+                {
+                    throw OpCoSerializerException("Unable to write a non-finite floating point value to JSON");
+                }
+            }
+            else
+            {
+                for (auto const& element : value)
+                {
+                    WriteJson<TElement>(writer, element);
+                }
+            }
+
+            writer.EndArray();
+        }
+
+        /// @remarks Existing elements are read into in place, reusing their
+        /// storage, and any left over are removed once the array ends. Elements
+        /// which are constructed from their properties are always appended.
+        /// Numbers are read straight from the input when it is in memory (see
+        /// ReadNumbers).
+        static void Read(JsonReadContext& context, std::vector<TElement>& value, JsonToken const& token)
+        {
+            if (token.type != JsonTokenType::StartArray)
+            {
+                token.ThrowUnexpected("an array");
+            }
+
+            if constexpr (IsConstructedFromPropertiesV<TElement>)
+            {
+                value.clear();
+            }
+
+            context.Push(&ReadElement, &value);
+
+            if constexpr (isNumber)
+            {
+                if (context.InputPosition() != nullptr)
+                {
+                    ReadNumbers(context, value);
+                }
+            }
+        }
+
         static std::vector<TElement> Deserialize(rapidjson::Value& value)
         {
             auto array = value.GetArray();
-            typename std::vector<TElement>::size_type i = 0;
-            std::vector<TElement> vector(array.Size());
+            std::vector<TElement> vector;
+            vector.reserve(array.Size());
 
             for (auto& jsonElement : array)
             {
-                vector[i] = JsonTypeSerializer<TElement>::Deserialize(jsonElement);
-                ++i;
+                vector.push_back(JsonTypeSerializer<TElement>::Deserialize(jsonElement));
             }
 
             return vector;
         }
+
+        private:
+            static bool constexpr isNumber = std::is_arithmetic_v<TElement> && !std::is_same_v<TElement, bool>;
+
+            static bool IsDigit(char c)
+            {
+                return c >= '0' && c <= '9';
+            }
+
+            static char const* SkipWhitespace(char const* current, char const* end)
+            {
+                while (current != end && (*current == ' ' || *current == '\n' || *current == '\r' || *current == '\t'))
+                {
+                    ++current;
+                }
+
+                return current;
+            }
+
+            // Parses a JSON number into the element type, returning the end of
+            // the number, or null if there is no number or it does not fit.
+            static char const* ParseNumber(char const* begin, char const* end, TElement& element)
+            {
+                auto current = begin;
+                if (current != end && *current == '-')
+                {
+                    ++current;
+                }
+
+                if (current == end || !IsDigit(*current))
+                {
+                    return nullptr;
+                }
+
+                if (*current++ != '0')
+                {
+                    while (current != end && IsDigit(*current))
+                    {
+                        ++current;
+                    }
+                }
+
+                bool integer = true;
+                if (current != end && *current == '.')
+                {
+                    integer = false;
+                    auto digits = ++current;
+                    while (current != end && IsDigit(*current))
+                    {
+                        ++current;
+                    }
+
+                    if (current == digits)
+                    {
+                        return nullptr;
+                    }
+                }
+
+                if (current != end && (*current == 'e' || *current == 'E'))
+                {
+                    integer = false;
+                    if (++current != end && (*current == '+' || *current == '-'))
+                    {
+                        ++current;
+                    }
+
+                    auto digits = current;
+                    while (current != end && IsDigit(*current))
+                    {
+                        ++current;
+                    }
+
+                    if (current == digits)
+                    {
+                        return nullptr;
+                    }
+                }
+
+                if constexpr (std::is_floating_point_v<TElement>)
+                {
+                    double number;
+                    if (std::from_chars(begin, current, number).ec != std::errc())
+                    {
+                        return nullptr;
+                    }
+
+                    element = static_cast<TElement>(number);
+                }
+                else if (!integer || std::from_chars(begin, current, element).ec != std::errc())
+                {
+                    return nullptr;
+                }
+
+                return current;
+            }
+
+            // Numbers are read from the input up to the end of the array,
+            // leaving the parser to read the closing bracket. Anything else,
+            // e.g. a hex float string, an integer out of range or invalid
+            // JSON, stops at the start of that element, which the parser then
+            // reads (or rejects) as usual. A comma followed by the end of the
+            // array stops at the number before it, so the parser rejects it.
+            static void ReadNumbers(JsonReadContext& context, std::vector<TElement>& vector)
+            {
+                auto& position = *context.InputPosition();
+                auto end = context.InputEnd();
+                std::size_t count = 0;
+                auto current = SkipWhitespace(position, end);
+                char const* previous = nullptr;
+                while (true)
+                {
+                    TElement element;
+                    auto numberEnd = ParseNumber(current, end, element);
+                    if (numberEnd == nullptr)
+                    {
+                        if (previous != nullptr && (current == end || *current == ']'))
+                        {
+                            current = previous;
+                            --count;
+                        }
+
+                        break;
+                    }
+
+                    auto next = SkipWhitespace(numberEnd, end);
+                    if (next == end || (*next != ',' && *next != ']'))
+                    {
+                        break;
+                    }
+
+                    if (count < vector.size())
+                    {
+                        vector[count] = element;
+                    }
+                    else
+                    {
+                        vector.push_back(element);
+                    }
+
+                    ++count;
+                    if (*next == ']')
+                    {
+                        current = next;
+                        break;
+                    }
+
+                    previous = current;
+                    current = SkipWhitespace(next + 1, end);
+                }
+
+                position = current;
+                context.Top().state = count;
+            }
+
+            static void ReadElement(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                auto& vector = *static_cast<std::vector<TElement>*>(frame.target);
+
+                if (token.type == JsonTokenType::EndArray)
+                {
+                    while (vector.size() > frame.state)
+                    {
+                        vector.pop_back();
+                    }
+
+                    context.Pop();
+                    return;
+                }
+
+                // The frame may be invalidated by reading the element.
+                auto index = frame.state++;
+                if constexpr (std::is_same_v<TElement, bool>)
+                {
+                    bool element = false;
+                    ReadJson(context, element, token);
+                    if (index < vector.size())
+                    {
+                        vector[index] = element;
+                    }
+                    else
+                    {
+                        vector.push_back(element);
+                    }
+                }
+                else if constexpr (IsConstructedFromPropertiesV<TElement>)
+                {
+                    JsonTypeSerializer<TElement>::Construct(context, token, &vector, [](void* destination, TElement&& element) {
+                        static_cast<std::vector<TElement>*>(destination)->push_back(std::move(element));
+                    });
+                }
+                else if (index < vector.size())
+                {
+                    ReadJson(context, vector[index], token);
+                }
+                else
+                {
+                    ReadJson(context, vector.emplace_back(), token);
+                }
+            }
+    };
+
+    /// Partial JsonTypeSerializer specialization for a columnar vector.
+    /// @remarks The vector is written as an object with an array per property,
+    /// e.g. {"x":[1,2],"y":[3,4]}, rather than an array of objects. Every
+    /// column must have the same length. When reading, existing elements are
+    /// read into in place and the first column read sets the number of
+    /// elements.
+    /// @tparam T The type of the elements.
+    template <typename T>
+    struct JsonTypeSerializer<Columnar<T>>
+    {
+        static rapidjson::Value Serialize(rapidjson::Document& document, Columnar<T> const& value)
+        {
+            rapidjson::Value object;
+            object.SetObject();
+
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+
+                rapidjson::Value column;
+                column.SetArray();
+                column.Reserve(static_cast<rapidjson::SizeType>(value.size()), document.GetAllocator());
+                for (auto const& row : value)
+                {
+                    column.PushBack(JsonTypeSerializer<Type>::Serialize(document, row.*(property.member)), document.GetAllocator());
+                }
+
+                object.AddMember(
+                    rapidjson::Value(rapidjson::StringRef(property.name, property.nameLength)),
+                    column,
+                    document.GetAllocator()
+                );
+            });
+
+            return object;
+        }
+
+        static std::size_t SizeBound(Columnar<T> const& value)
+        {
+            auto bound = JsonContainerSizeBound(PropertyCountV<T>);
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                bound += JsonKeySizeBound(property.nameLength) + JsonContainerSizeBound(value.size());
+                if constexpr (JsonFixedSizeBoundV<Type> != 0)
+                {
+                    bound += value.size() * JsonFixedSizeBoundV<Type>;
+                }
+                else
+                {
+                    for (auto const& row : value)
+                    {
+                        bound += SerializedSizeBound<Type>(row.*(property.member));
+                    }
+                }
+            });
+
+            return bound;
+        }
+
+        template <typename TWriter>
+        static void Write(TWriter& writer, Columnar<T> const& value)
+        {
+            writer.StartObject();
+
+            std::size_t index = 0;
+            ForProperty<T>([&](auto& property) {
+                using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                JsonKeys<T>::Write(writer, index++);
+
+                writer.StartArray();
+                WriteWithNumberFormat(writer, property, [&] {
+                    for (auto const& row : value)
+                    {
+                        WriteJson<Type>(writer, row.*(property.member));
+                    }
+                });
+
+                writer.EndArray();
+            });
+
+            writer.EndObject();
+        }
+
+        static void Read(JsonReadContext& context, Columnar<T>& value, JsonToken const& token)
+        {
+            if (token.type != JsonTokenType::StartObject)
+            {
+                token.ThrowUnexpected("an object");
+            }
+
+            context.Push(&ReadColumnKey, &value, PropertyCountV<T>);
+        }
+
+        static Columnar<T> Deserialize(rapidjson::Value& value)
+        {
+            if (!value.IsObject())
+            {
+                throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an object");
+            }
+
+            Columnar<T> rows;
+            std::bitset<PropertyCountV<T>> seen;
+            for (auto& member : value.GetObject())
+            {
+                auto index = PropertyLookup<T>::Find(member.name.GetString(), member.name.GetStringLength());
+                if (index == PropertyLookup<T>::npos)
+                {
+                    continue;
+                }
+
+                if (!member.value.IsArray())
+                {
+                    throw OpCoSerializerException("Unexpected JSON value during deserialization - expected an array");
+                }
+
+                auto column = member.value.GetArray();
+                if (seen.none())
+                {
+                    rows.resize(column.Size());
+                }
+
+                seen.set(index);
+                ForPropertyAt<T>(index, [&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    if (column.Size() != rows.size())
+                    {
+                        ThrowLengthMismatch(property.name);
+                    }
+
+                    for (rapidjson::SizeType i = 0; i < column.Size(); ++i)
+                    {
+                        rows[i].*(property.member) = JsonTypeSerializer<Type>::Deserialize(column[i]);
+                    }
+                });
+            }
+
+            if (!seen.all())
+            {
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    if (!seen.test(index++))
+                    {
+                        throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                    }
+                });
+            }
+
+            return rows;
+        }
+
+        private:
+            [[noreturn]] static void ThrowLengthMismatch(char const* name)
+            {
+                throw OpCoSerializerException(std::string("Column length mismatch during deserialization - ") + name);
+            }
+
+            static void ReadColumnKey(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                if (token.type == JsonTokenType::Key)
+                {
+                    auto index = PropertyLookup<T>::Find(token.string, token.length);
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        context.Skip();
+                        return;
+                    }
+
+                    if (frame.required)
+                    {
+                        context.MarkSeen(frame, index);
+                    }
+
+                    // The state counts the columns read so far.
+                    auto first = frame.state++ == 0;
+                    ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                        context.ExpectWith(first ? &ReadColumn<decltype(i)::value, true> : &ReadColumn<decltype(i)::value, false>, frame.target);
+                    });
+                }
+                else if (token.type == JsonTokenType::EndObject)
+                {
+                    if (frame.required)
+                    {
+                        std::size_t index = 0;
+                        ForProperty<T>([&](auto& property) {
+                            if (!context.Seen(frame, index++))
+                            {
+                                throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                            }
+                        });
+                    }
+
+                    context.Pop();
+                }
+            }
+
+            template <std::size_t I, bool First>
+            static void ReadColumn(JsonReadContext& context, void* target, JsonToken const& token)
+            {
+                if (token.type != JsonTokenType::StartArray)
+                {
+                    token.ThrowUnexpected("an array");
+                }
+
+                context.Push(&ReadCell<I, First>, target);
+            }
+
+            /// @remarks The first column grows or shrinks the vector, after
+            /// which every other column must match its length.
+            template <std::size_t I, bool First>
+            static void ReadCell(JsonReadContext& context, JsonReadFrame& frame, JsonToken const& token)
+            {
+                auto& rows = *static_cast<Columnar<T>*>(frame.target);
+                auto const property = std::get<I>(T::SerializerProperties());
+
+                if (token.type == JsonTokenType::EndArray)
+                {
+                    if constexpr (First)
+                    {
+                        while (rows.size() > frame.state)
+                        {
+                            rows.pop_back();
+                        }
+                    }
+                    else if (rows.size() != frame.state)
+                    {
+                        ThrowLengthMismatch(property.name);
+                    }
+
+                    context.Pop();
+                    return;
+                }
+
+                // The frame may be invalidated by reading the element.
+                auto index = frame.state++;
+                if (index == rows.size())
+                {
+                    if constexpr (!First)
+                    {
+                        ThrowLengthMismatch(property.name);
+                    }
+
+                    rows.emplace_back();
+                }
+
+                ReadJson(context, rows[index].*(property.member), token);
+            }
     };
 
     /// JsonTypeSerializer specialization for a C++ string.
     template <>
     struct JsonTypeSerializer<std::string>
     {
-        static rapidjson::Value Serialize(rapidjson::Document& document, std::string& value)
+        static rapidjson::Value Serialize(rapidjson::Document& document, std::string const& value)
         {
             rapidjson::Value string;
-            string.SetString(value.c_str(), value.size(), document.GetAllocator());
+            string.SetString(value.c_str(), static_cast<rapidjson::SizeType>(value.size()), document.GetAllocator());
             return string;
         }
 
+        static std::size_t SizeBound(std::string const& value)
+        {
+            return JsonStringSizeBound(value);
+        }
+
+        template <typename TWriter>
+        static void Write(TWriter& writer, std::string const& value)
+        {
+            writer.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()));
+        }
+
+        static void Read(JsonReadContext&, std::string& value, JsonToken const& token)
+        {
+            if (token.type != JsonTokenType::String)
+            {
+                token.ThrowUnexpected("a string");
+            }
+
+            value.assign(token.string, token.length);
+        }
+
         static std::string Deserialize(rapidjson::Value& value)
         {
-            return std::string(value.GetString());
+            return std::string(value.GetString(), value.GetStringLength());
+        }
+    };
+
+    /// JsonTypeSerializer specialization for a C++ string view.
+    /// @remarks A string view can only be read when parsing in situ, as it
+    /// refers to the characters in the parsed buffer, e.g. through
+    /// JsonSerializer::DeserializeInsitu.
+    template <>
+    struct JsonTypeSerializer<std::string_view>
+    {
+        static rapidjson::Value Serialize(rapidjson::Document&, std::string_view const& value)
+        {
+            return rapidjson::Value(rapidjson::StringRef(value.data(), value.size()));
+        }
+
+        static std::size_t SizeBound(std::string_view const& value)
+        {
+            return JsonStringSizeBound(value);
+        }
+
+        template <typename TWriter>
+        static void Write(TWriter& writer, std::string_view const& value)
+        {
+            writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+        }
+
+        static void Read(JsonReadContext&, std::string_view& value, JsonToken const& token)
+        {
+            if (token.type != JsonTokenType::String)
+            {
+                token.ThrowUnexpected("a string");
+            }
+
+            // Copied strings only live until the next token.
+            if (token.copy)
+            {
+                throw OpCoSerializerException("A string view can only be deserialized when parsing in situ");
+            }
+
+            value = std::string_view(token.string, token.length);
+        }
+
+        /// @remarks The view refers to the characters held by the value.
+        static std::string_view Deserialize(rapidjson::Value& value)
+        {
+            return std::string_view(value.GetString(), value.GetStringLength());
         }
     };
 }
@@ -0,0 +1,238 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_NDJSON_PARALLEL_HPP
+#define OPCOSERIALIZER_JSON_NDJSON_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Json/JsonSerializerSettings.hpp"
+#include "OpCoSerializer/Json/NdjsonReader.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// The smallest chunk NDJSON input is split into when read in parallel.
+    /// Smaller inputs are read by fewer threads.
+    std::size_t constexpr NdjsonMinimumChunkSize = 64 * 1024;
+
+    /// The number of chunks per thread NDJSON input is split into when read
+    /// in parallel, so that threads finishing early can take more work.
+    std::size_t constexpr NdjsonChunksPerThread = 4;
+
+    /// Splits NDJSON input into roughly equal chunks at line boundaries.
+    /// @remarks Every chunk but the last ends with a newline, and no chunk is
+    /// empty, so there may be fewer chunks than requested.
+    /// @param input The records.
+    /// @param chunkCount The number of chunks to aim for.
+    /// @returns The chunks, in order.
+    inline std::vector<std::string_view> SplitNdjson(std::string_view input, std::size_t chunkCount)
+    {
+        std::vector<std::string_view> chunks;
+        chunkCount = std::max<std::size_t>(chunkCount, 1);
+        auto targetSize = input.size() / chunkCount + 1;
+
+        std::size_t start = 0;
+        while (start < input.size())
+        {
+            auto end = input.size();
+            if (input.size() - start > targetSize)
+            {
+                auto newline = input.find('\n', start + targetSize - 1);
+                if (newline != std::string_view::npos)
+                {
+                    end = newline + 1;
+                }
+            }
+
+            chunks.push_back(input.substr(start, end - start));
+            start = end;
+        }
+
+        return chunks;
+    }
+
+    /// Reads NDJSON records across several threads, passing each chunk of
+    /// records to a callback as it is completed.
+    /// @remarks The input is split at line boundaries and each thread reads
+    /// chunks with its own NdjsonReader. The callback is invoked from the
+    /// reading threads, possibly at the same time, and chunks may complete
+    /// in any order. The first exception thrown stops the remaining chunks
+    /// and is rethrown once all threads have finished.
+    /// @tparam T the type of the records.
+    /// @param input The records, e.g. a memory mapped file.
+    /// @param callback Invoked with the index of each chunk and its records.
+    /// @param threadCount The number of threads to use, including the calling
+    /// thread. Zero to use the hardware concurrency.
+    /// @param settings The settings.
+    template <typename T, typename TCallback>
+        requires std::invocable<TCallback&, std::size_t, std::vector<T>&&>
+    void ReadNdjsonParallel(
+        std::string_view input,
+        TCallback&& callback,
+        std::size_t threadCount = 0,
+        JsonSerializerSettings const& settings = JsonSerializerSettings())
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        auto chunkCount = std::min(threadCount * NdjsonChunksPerThread, input.size() / NdjsonMinimumChunkSize + 1);
+        auto chunks = SplitNdjson(input, chunkCount);
+        threadCount = std::min(threadCount, chunks.size());
+
+        std::atomic<std::size_t> nextChunk{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto work = [&]()
+        {
+            // Each thread reuses a single reader for all of its chunks.
+            std::optional<NdjsonReader<T>> reader;
+            while (!failed)
+            {
+                auto index = nextChunk++;
+                if (index >= chunks.size())
+                {
+                    break;
+                }
+
+                try
+                {
+                    if (reader)
+                    {
+                        reader->Reset(chunks[index]);
+                    }
+                    else
+                    {
+                        reader.emplace(chunks[index], JsonSerializerSettings(settings));
+                    }
+
+                    std::vector<T> records;
+                    while (reader->Next(records.emplace_back()))
+                    {
+                    }
+
+                    records.pop_back();
+                    callback(index, std::move(records));
+                }
+                catch (OpCoSerializerException const& exception)
+                {
+                    // Offsets within the chunk are not meaningful on their own.
+                    auto offset = static_cast<std::size_t>(chunks[index].data() - input.data());
+                    std::scoped_lock lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::make_exception_ptr(OpCoSerializerException(
+                            std::string(exception.what()) + " in chunk starting at offset " + std::to_string(offset)));
+                    }
+
+                    failed = true;
+                }
+                catch (...)
+                {
+                    std::scoped_lock lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+
+                    failed = true;
+                }
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+            for (std::size_t i = 1; i < threadCount; ++i)
+            {
+                threads.emplace_back(work);
+            }
+
+            work();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /// Reads NDJSON records across several threads.
+    /// @remarks See ReadNdjsonParallel with a callback. The records are
+    /// returned in the order they appear in the input.
+    /// @tparam T the type of the records.
+    /// @param input The records, e.g. a memory mapped file.
+    /// @param threadCount The number of threads to use, including the calling
+    /// thread. Zero to use the hardware concurrency.
+    /// @param settings The settings.
+    /// @returns The records.
+    template <typename T>
+    std::vector<T> ReadNdjsonParallel(
+        std::string_view input,
+        std::size_t threadCount = 0,
+        JsonSerializerSettings const& settings = JsonSerializerSettings())
+    {
+        std::vector<std::vector<T>> chunks;
+        std::mutex chunksMutex;
+        ReadNdjsonParallel<T>(
+            input,
+            [&](std::size_t index, std::vector<T>&& records)
+            {
+                std::scoped_lock lock(chunksMutex);
+                if (chunks.size() <= index)
+                {
+                    chunks.resize(index + 1);
+                }
+
+                chunks[index] = std::move(records);
+            },
+            threadCount,
+            settings);
+
+        std::size_t count = 0;
+        for (auto const& chunk : chunks)
+        {
+            count += chunk.size();
+        }
+
+        std::vector<T> records;
+        records.reserve(count);
+        for (auto& chunk : chunks)
+        {
+            std::move(chunk.begin(), chunk.end(), std::back_inserter(records));
+        }
+
+        return records;
+    }
+}
+
+#endif // OPCOSERIALIZER_JSON_NDJSON_PARALLEL_HPP
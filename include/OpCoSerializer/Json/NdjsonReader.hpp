@@ -0,0 +1,250 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_NDJSON_READER_HPP
+#define OPCOSERIALIZER_JSON_NDJSON_READER_HPP
+
+#include <cstdio>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Json/JsonSerializerSettings.hpp"
+#include "OpCoSerializer/Json/JsonReadContext.hpp"
+#include "OpCoSerializer/Json/JsonStreams.hpp"
+#include "OpCoSerializer/Json/JsonKeys.hpp"
+#include "OpCoSerializer/Json/JsonTypeSerializer.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// Reads values of type T from newline-delimited JSON (NDJSON), one
+    /// record at a time.
+    /// @remarks A single parser and read state are reused for every record,
+    /// and the parser stops as soon as each record is complete, so the input
+    /// is never split into lines or copied. Files and streams are read
+    /// through a fixed size buffer. After an exception is thrown the position
+    /// in the input is unspecified and the reader should be discarded. An
+    /// NdjsonReader must not be used from multiple threads at once.
+    /// @tparam T the type of the records.
+    template <typename T>
+    class NdjsonReader final
+    {
+        public:
+            /// An input iterator over the records of an NdjsonReader.
+            class Iterator final
+            {
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = T const*;
+                    using reference = T const&;
+
+                    /// Initializes a new instance of the Iterator type which
+                    /// marks the end of the records.
+                    Iterator() = default;
+
+                    /// Initializes a new instance of the Iterator type,
+                    /// reading the first record.
+                    /// @param reader The reader.
+                    explicit Iterator(NdjsonReader* reader)
+                        : _reader(reader)
+                    {
+                        ++*this;
+                    }
+
+                    reference operator*() const
+                    {
+                        return *_reader->_current;
+                    }
+
+                    pointer operator->() const
+                    {
+                        return &*_reader->_current;
+                    }
+
+                    Iterator& operator++()
+                    {
+                        // Each record starts from a default instance, matching
+                        // JsonSerializer::Deserialize.
+                        _reader->_current.emplace();
+                        if (!_reader->Next(*_reader->_current))
+                        {
+                            _reader = nullptr;
+                        }
+
+                        return *this;
+                    }
+
+                    void operator++(int)
+                    {
+                        ++*this;
+                    }
+
+                    bool operator==(Iterator const& other) const
+                    {
+                        return _reader == other._reader;
+                    }
+
+                private:
+                    NdjsonReader* _reader = nullptr;
+            };
+
+            /// Initializes a new instance of the NdjsonReader type which
+            /// reads records from memory.
+            /// @param input The records. Must outlive the reader.
+            /// @param settings The settings.
+            explicit NdjsonReader(std::string_view input, JsonSerializerSettings&& settings = JsonSerializerSettings())
+                : _state(std::make_unique<State>(settings.propertiesRequired, input))
+            {
+            }
+
+            /// Initializes a new instance of the NdjsonReader type which
+            /// reads records from a file.
+            /// @param file The file, opened for reading.
+            /// @param settings The settings.
+            explicit NdjsonReader(std::FILE* file, JsonSerializerSettings&& settings = JsonSerializerSettings())
+                : _state(std::make_unique<State>(settings.propertiesRequired, file))
+            {
+            }
+
+            /// Initializes a new instance of the NdjsonReader type which
+            /// reads records from a stream.
+            /// @param input The stream.
+            /// @param settings The settings.
+            explicit NdjsonReader(std::istream& input, JsonSerializerSettings&& settings = JsonSerializerSettings())
+                : _state(std::make_unique<State>(settings.propertiesRequired, input))
+            {
+            }
+
+            /// Reads the next record into an existing value.
+            /// @remarks The value's storage, e.g. the capacity of its strings
+            /// and vectors, is reused. Members missing from the record keep
+            /// their current values.
+            /// @param record The value to read into.
+            /// @returns Whether or not a record was read, false at the end of
+            /// the input.
+            bool Next(T& record)
+            {
+                return std::visit([this, &record](auto& stream) { return Read(stream, record); }, _state->stream);
+            }
+
+            /// Starts reading records from memory, reusing the parser and
+            /// read state.
+            /// @param input The records. Must outlive the reader.
+            void Reset(std::string_view input)
+            {
+                _state->stream.template emplace<rapidjson::MemoryStream>(input.data(), input.size());
+                _state->count = 0;
+            }
+
+            /// Gets an iterator which reads the first record.
+            /// @returns The iterator.
+            Iterator begin()
+            {
+                return Iterator(this);
+            }
+
+            /// Gets the iterator marking the end of the records.
+            /// @returns The iterator.
+            Iterator end() const
+            {
+                return Iterator();
+            }
+
+            /// Gets the number of records read.
+            /// @returns The number of records.
+            std::size_t Count() const
+            {
+                return _state->count;
+            }
+
+        private:
+            using Stream = std::variant<rapidjson::MemoryStream, rapidjson::FileReadStream, IStreamReadStream>;
+
+            struct State final
+            {
+                rapidjson::Reader reader;
+                JsonReadContext context;
+                std::unique_ptr<char[]> buffer;
+                Stream stream;
+                std::size_t count = 0;
+
+                State(bool propertiesRequired, std::string_view input)
+                    : context(propertiesRequired),
+                      stream(std::in_place_type<rapidjson::MemoryStream>, input.data(), input.size())
+                {
+                }
+
+                State(bool propertiesRequired, std::FILE* file)
+                    : context(propertiesRequired),
+                      buffer(std::make_unique<char[]>(JsonStreamBufferSize)),
+                      stream(std::in_place_type<rapidjson::FileReadStream>, file, buffer.get(), JsonStreamBufferSize)
+                {
+                }
+
+                State(bool propertiesRequired, std::istream& input)
+                    : context(propertiesRequired),
+                      buffer(std::make_unique<char[]>(JsonStreamBufferSize)),
+                      stream(std::in_place_type<IStreamReadStream>, input, buffer.get(), JsonStreamBufferSize)
+                {
+                }
+            };
+
+            // The streams refer to the buffer, so they are kept together on
+            // the heap to allow the NdjsonReader to be moved.
+            std::unique_ptr<State> _state;
+            std::optional<T> _current;
+
+            template <typename TStream>
+            bool Read(TStream& stream, T& record)
+            {
+                auto& state = *_state;
+                rapidjson::SkipWhitespace(stream);
+                if (stream.Peek() == '\0')
+                {
+                    return false;
+                }
+
+                // The parser stops at the end of the record, leaving the
+                // stream positioned at the start of the next line.
+                state.context.Reset();
+                state.context.SetInput(stream);
+
+                state.context.Expect(record);
+                auto result = state.reader.template Parse<JsonParseFlags | rapidjson::kParseStopWhenDoneFlag>(stream, state.context);
+                if (result.IsError())
+                {
+                    ThrowParseError(result, "NDJSON record " + std::to_string(state.count + 1));
+                }
+
+                ++state.count;
+                return true;
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_JSON_NDJSON_READER_HPP
@@ -0,0 +1,199 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_JSON_NDJSON_WRITER_HPP
+#define OPCOSERIALIZER_JSON_NDJSON_WRITER_HPP
+
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Json/JsonReadContext.hpp"
+#include "OpCoSerializer/Json/JsonNumberFormat.hpp"
+#include "OpCoSerializer/Json/JsonStreams.hpp"
+#include "OpCoSerializer/Json/JsonKeys.hpp"
+#include "OpCoSerializer/Json/JsonTypeSerializer.hpp"
+
+namespace OpCoSerializer::Json
+{
+    /// Writes values of type T as newline-delimited JSON (NDJSON), one
+    /// compact record per line.
+    /// @remarks Records are appended to a single buffer which is reused for
+    /// the lifetime of the writer. When writing to a file or stream, the
+    /// buffer is drained whenever it grows past JsonStreamBufferSize, so once
+    /// warmed up, writing a record does not allocate. An NdjsonWriter must not
+    /// be used from multiple threads at once.
+    /// @tparam T the type of the records.
+    template <typename T>
+    class NdjsonWriter final
+    {
+        public:
+            /// Initializes a new instance of the NdjsonWriter type which
+            /// appends records to an in-memory buffer.
+            NdjsonWriter()
+                : _state(std::make_unique<State>())
+            {
+            }
+
+            /// Initializes a new instance of the NdjsonWriter type which
+            /// writes records to a file.
+            /// @param file The file, opened for writing.
+            explicit NdjsonWriter(std::FILE* file)
+                : _state(std::make_unique<State>())
+            {
+                _state->file = file;
+            }
+
+            /// Initializes a new instance of the NdjsonWriter type which
+            /// writes records to a stream.
+            /// @param output The stream.
+            explicit NdjsonWriter(std::ostream& output)
+                : _state(std::make_unique<State>())
+            {
+                _state->output = &output;
+            }
+
+            NdjsonWriter(NdjsonWriter const&) = delete;
+            NdjsonWriter(NdjsonWriter&&) noexcept = default;
+            NdjsonWriter& operator=(NdjsonWriter const&) = delete;
+            NdjsonWriter& operator=(NdjsonWriter&&) noexcept = default;
+
+            /// Writes any buffered records to the file or stream.
+            ~NdjsonWriter()
+            {
+                if (_state && IsDraining())
+                {
+                    Drain();
+                }
+            }
+
+            /// Appends a record.
+            /// @remarks If the record cannot be written, e.g. it holds a
+            /// non-finite number, any part of it already written is removed,
+            /// so later records start on their own line.
+            /// @param record The record.
+            void Write(T const& record)
+            {
+                auto& state = *_state;
+                auto size = state.buffer.GetSize();
+                state.writer.Reset(state.buffer);
+                try
+                {
+                    WriteJson(state.writer, record);
+                }
+                catch (...)
+                {
+                    state.buffer.Pop(state.buffer.GetSize() - size);
+                    throw;
+                }
+
+                state.buffer.Put('\n');
+                ++state.count;
+
+                if (IsDraining() && state.buffer.GetSize() >= JsonStreamBufferSize)
+                {
+                    Flush();
+                }
+            }
+
+            /// Writes any buffered records to the file or stream.
+            /// @remarks Does nothing when writing to an in-memory buffer.
+            void Flush()
+            {
+                if (!IsDraining())
+                {
+                    return;
+                }
+
+                Drain();
+                if ((_state->file && std::ferror(_state->file)) || (_state->output && !*_state->output))
+                {
+                    throw OpCoSerializerException("Error whilst writing NDJSON records");
+                }
+            }
+
+            /// Gets the records written to an in-memory buffer, or those not yet
+            /// flushed to a file or stream.
+            /// @returns The records, one per line.
+            std::string_view View() const
+            {
+                return std::string_view(_state->buffer.GetString(), _state->buffer.GetSize());
+            }
+
+            /// Clears the in-memory buffer, keeping its capacity.
+            void Clear()
+            {
+                _state->buffer.Clear();
+            }
+
+            /// Gets the number of records written.
+            /// @returns The number of records.
+            std::size_t Count() const
+            {
+                return _state->count;
+            }
+
+        private:
+            struct State final
+            {
+                rapidjson::StringBuffer buffer;
+                JsonWriter<rapidjson::Writer<rapidjson::StringBuffer>> writer;
+                std::FILE* file = nullptr;
+                std::ostream* output = nullptr;
+                std::size_t count = 0;
+
+                State()
+                    : writer(buffer)
+                {
+                }
+            };
+
+            // The writer and its buffer refer to each other, so they are kept
+            // together on the heap to allow the NdjsonWriter to be moved.
+            std::unique_ptr<State> _state;
+
+            bool IsDraining() const
+            {
+                return _state->file != nullptr || _state->output != nullptr;
+            }
+
+            void Drain()
+            {
+                auto& state = *_state;
+                if (state.file)
+                {
+                    std::fwrite(state.buffer.GetString(), 1, state.buffer.GetSize(), state.file);
+                    std::fflush(state.file);
+                }
+                else
+                {
+                    state.output->write(state.buffer.GetString(), static_cast<std::streamsize>(state.buffer.GetSize()));
+                    state.output->flush();
+                }
+
+                state.buffer.Clear();
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_JSON_NDJSON_WRITER_HPP
@@ -0,0 +1,554 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_MSGPACK_STREAMS_HPP
+#define OPCOSERIALIZER_MSGPACK_STREAMS_HPP
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::MsgPack
+{
+    /// Appends MessagePack encoded values to a string.
+    /// @remarks Each value is written in the smallest format that represents
+    /// it exactly, e.g. a positive fixint for small integers and a float 32
+    /// for doubles which have no more precision than a float.
+    class MsgPackWriter final
+    {
+        public:
+            /// Initializes a new instance of the MsgPackWriter type.
+            /// @param output The string to append to.
+            explicit MsgPackWriter(std::string& output)
+                : _output(output)
+            {
+            }
+
+            /// Appends nil.
+            void WriteNil()
+            {
+                WriteByte(0xc0);
+            }
+
+            /// Appends a boolean.
+            /// @param value The boolean.
+            void WriteBool(bool value)
+            {
+                WriteByte(value ? 0xc3 : 0xc2);
+            }
+
+            /// Appends an integer.
+            /// @param value The integer.
+            template <typename T>
+                requires std::is_integral_v<T>
+            void WriteInteger(T value)
+            {
+                if constexpr (std::is_signed_v<T>)
+                {
+                    if (value < 0)
+                    {
+                        WriteNegative(static_cast<int64_t>(value));
+                        return;
+                    }
+                }
+
+                WriteUnsigned(static_cast<uint64_t>(value));
+            }
+
+            /// Appends a floating point number, as a float 32 if that is exact.
+            /// @param value The number.
+            template <typename T>
+                requires std::is_floating_point_v<T>
+            void WriteFloat(T value)
+            {
+                auto constexpr floatMax = static_cast<double>(std::numeric_limits<float>::max());
+                auto number = static_cast<double>(value);
+                if (!std::isfinite(number)
+                    || (std::fabs(number) <= floatMax && static_cast<double>(static_cast<float>(number)) == number))
+                {
+                    WriteByte(0xca);
+                    WriteBigEndian(static_cast<float>(number));
+                }
+                else
+                {
+                    WriteByte(0xcb);
+                    WriteBigEndian(number);
+                }
+            }
+
+            /// Appends a string.
+            /// @param data The characters. Do not need to be null terminated.
+            /// @param length The number of characters.
+            void WriteString(char const* data, std::size_t length)
+            {
+                if (length < 32)
+                {
+                    WriteByte(static_cast<unsigned char>(0xa0 | length));
+                }
+                else if (length <= std::numeric_limits<uint8_t>::max())
+                {
+                    WriteByte(0xd9);
+                    WriteByte(static_cast<unsigned char>(length));
+                }
+                else
+                {
+                    WriteHeader(0xda, 0xdb, length);
+                }
+
+                _output.append(data, length);
+            }
+
+            /// Appends the header of an array, which must be followed by its elements.
+            /// @param size The number of elements.
+            void WriteArrayHeader(std::size_t size)
+            {
+                if (size < 16)
+                {
+                    WriteByte(static_cast<unsigned char>(0x90 | size));
+                }
+                else
+                {
+                    WriteHeader(0xdc, 0xdd, size);
+                }
+            }
+
+            /// Appends the header of a map, which must be followed by its keys
+            /// and values in turn.
+            /// @param size The number of key value pairs.
+            void WriteMapHeader(std::size_t size)
+            {
+                if (size < 16)
+                {
+                    WriteByte(static_cast<unsigned char>(0x80 | size));
+                }
+                else
+                {
+                    WriteHeader(0xde, 0xdf, size);
+                }
+            }
+
+        private:
+            std::string& _output;
+
+            void WriteByte(unsigned char byte)
+            {
+                _output.push_back(static_cast<char>(byte));
+            }
+
+            template <typename T>
+            void WriteBigEndian(T value)
+            {
+                auto bigEndian = NativeToBigEndian(value);
+                _output.append(reinterpret_cast<char const*>(&bigEndian), sizeof(T));
+            }
+
+            void WriteUnsigned(uint64_t value)
+            {
+                if (value < 0x80)
+                {
+                    WriteByte(static_cast<unsigned char>(value));
+                }
+                else if (value <= std::numeric_limits<uint8_t>::max())
+                {
+                    WriteByte(0xcc);
+                    WriteBigEndian(static_cast<uint8_t>(value));
+                }
+                else if (value <= std::numeric_limits<uint16_t>::max())
+                {
+                    WriteByte(0xcd);
+                    WriteBigEndian(static_cast<uint16_t>(value));
+                }
+                else if (value <= std::numeric_limits<uint32_t>::max())
+                {
+                    WriteByte(0xce);
+                    WriteBigEndian(static_cast<uint32_t>(value));
+                }
+                else
+                {
+                    WriteByte(0xcf);
+                    WriteBigEndian(value);
+                }
+            }
+
+            void WriteNegative(int64_t value)
+            {
+                if (value >= -32)
+                {
+                    WriteByte(static_cast<unsigned char>(value));
+                }
+                else if (value >= std::numeric_limits<int8_t>::min())
+                {
+                    WriteByte(0xd0);
+                    WriteBigEndian(static_cast<int8_t>(value));
+                }
+                else if (value >= std::numeric_limits<int16_t>::min())
+                {
+                    WriteByte(0xd1);
+                    WriteBigEndian(static_cast<int16_t>(value));
+                }
+                else if (value >= std::numeric_limits<int32_t>::min())
+                {
+                    WriteByte(0xd2);
+                    WriteBigEndian(static_cast<int32_t>(value));
+                }
+                else
+                {
+                    WriteByte(0xd3);
+                    WriteBigEndian(value);
+                }
+            }
+
+            /// Writes the 16 or 32 bit form of a string, array or map header.
+            void WriteHeader(unsigned char format16, unsigned char format32, std::size_t size)
+            {
+                if (size <= std::numeric_limits<uint16_t>::max())
+                {
+                    WriteByte(format16);
+                    WriteBigEndian(static_cast<uint16_t>(size));
+                }
+                else if (size <= std::numeric_limits<uint32_t>::max())
+                {
+                    WriteByte(format32);
+                    WriteBigEndian(static_cast<uint32_t>(size));
+                }
+                else
+                {
+                    throw OpCoSerializerException("Size too large for MessagePack during serialization");
+                }
+            }
+    };
+
+    /// Reads MessagePack encoded values from a buffer, one at a time, without
+    /// building an intermediate tree.
+    /// @remarks Every read is bounds checked, throwing an OpCoSerializerException
+    /// rather than reading beyond the end of the buffer. Any format may be read
+    /// for a number as long as the value fits in the requested type.
+    class MsgPackReader final
+    {
+        public:
+            /// Initializes a new instance of the MsgPackReader type.
+            /// @param input The buffer. Must outlive the reader.
+            /// @param propertiesRequired Whether or not all properties of the
+            /// outermost object must be present.
+            explicit MsgPackReader(std::string_view input, bool propertiesRequired = false)
+                : _position(input.data()),
+                  _end(input.data() + input.size()),
+                  _propertiesRequired(propertiesRequired)
+            {
+            }
+
+            /// Reads a boolean.
+            /// @returns The boolean.
+            bool ReadBool()
+            {
+                auto format = ReadByte();
+                if (format != 0xc2 && format != 0xc3)
+                {
+                    ThrowUnexpected("a boolean");
+                }
+
+                return format == 0xc3;
+            }
+
+            /// Reads a number, checking that it fits in T.
+            /// @remarks Integers may be read as floating point numbers, but not
+            /// the other way around.
+            /// @returns The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+            T ReadNumber()
+            {
+                auto format = ReadByte();
+                if (format <= 0x7f)
+                {
+                    return FromUnsigned<T>(format);
+                }
+
+                if (format >= 0xe0)
+                {
+                    return FromSigned<T>(static_cast<int8_t>(format));
+                }
+
+                switch (format)
+                {
+                    case 0xcc: return FromUnsigned<T>(ReadBigEndian<uint8_t>());
+                    case 0xcd: return FromUnsigned<T>(ReadBigEndian<uint16_t>());
+                    case 0xce: return FromUnsigned<T>(ReadBigEndian<uint32_t>());
+                    case 0xcf: return FromUnsigned<T>(ReadBigEndian<uint64_t>());
+                    case 0xd0: return FromSigned<T>(ReadBigEndian<int8_t>());
+                    case 0xd1: return FromSigned<T>(ReadBigEndian<int16_t>());
+                    case 0xd2: return FromSigned<T>(ReadBigEndian<int32_t>());
+                    case 0xd3: return FromSigned<T>(ReadBigEndian<int64_t>());
+                    case 0xca:
+                    case 0xcb:
+                        if constexpr (std::is_floating_point_v<T>)
+                        {
+                            return format == 0xca
+                                ? static_cast<T>(ReadBigEndian<float>())
+                                : static_cast<T>(ReadBigEndian<double>());
+                        }
+                        else
+                        {
+                            ThrowUnexpected("an integer");
+                        }
+                    default:
+                        ThrowUnexpected(std::is_floating_point_v<T> ? "a number" : "an integer");
+                }
+            }
+
+            /// Reads a string.
+            /// @returns The characters, which remain in the buffer.
+            std::string_view ReadString()
+            {
+                auto format = ReadByte();
+                std::size_t length;
+                if ((format & 0xe0) == 0xa0)
+                {
+                    length = format & 0x1f;
+                }
+                else if (format == 0xd9)
+                {
+                    length = ReadBigEndian<uint8_t>();
+                }
+                else if (format == 0xda)
+                {
+                    length = ReadBigEndian<uint16_t>();
+                }
+                else if (format == 0xdb)
+                {
+                    length = ReadBigEndian<uint32_t>();
+                }
+                else
+                {
+                    ThrowUnexpected("a string");
+                }
+
+                return std::string_view(ReadBytes(length), length);
+            }
+
+            /// Reads the header of an array.
+            /// @returns The number of elements that follow.
+            std::size_t ReadArrayHeader()
+            {
+                auto format = ReadByte();
+                if ((format & 0xf0) == 0x90)
+                {
+                    return format & 0x0f;
+                }
+
+                switch (format)
+                {
+                    case 0xdc: return ReadBigEndian<uint16_t>();
+                    case 0xdd: return ReadBigEndian<uint32_t>();
+                    default: ThrowUnexpected("an array");
+                }
+            }
+
+            /// Reads the header of a map.
+            /// @returns The number of key value pairs that follow.
+            std::size_t ReadMapHeader()
+            {
+                auto format = ReadByte();
+                if ((format & 0xf0) == 0x80)
+                {
+                    return format & 0x0f;
+                }
+
+                switch (format)
+                {
+                    case 0xde: return ReadBigEndian<uint16_t>();
+                    case 0xdf: return ReadBigEndian<uint32_t>();
+                    default: ThrowUnexpected("a map");
+                }
+            }
+
+            /// Skips over the next value, including everything nested in it.
+            void Skip()
+            {
+                // The number of values left to skip, rather than recursion,
+                // so that deeply nested input cannot overflow the stack.
+                std::size_t pending = 1;
+                while (pending-- != 0)
+                {
+                    auto format = ReadByte();
+                    std::size_t length = 0;
+                    std::size_t children = 0;
+                    if (format <= 0x7f || format >= 0xe0 || format == 0xc0 || format == 0xc2 || format == 0xc3)
+                    {
+                        continue;
+                    }
+
+                    if ((format & 0xf0) == 0x80)
+                    {
+                        children = static_cast<std::size_t>(format & 0x0f) * 2;
+                    }
+                    else if ((format & 0xf0) == 0x90)
+                    {
+                        children = format & 0x0f;
+                    }
+                    else if ((format & 0xe0) == 0xa0)
+                    {
+                        length = format & 0x1f;
+                    }
+                    else
+                    {
+                        switch (format)
+                        {
+                            case 0xcc: case 0xd0: length = 1; break;
+                            case 0xcd: case 0xd1: length = 2; break;
+                            case 0xca: case 0xce: case 0xd2: length = 4; break;
+                            case 0xcb: case 0xcf: case 0xd3: length = 8; break;
+                            case 0xc4: case 0xd9: length = ReadBigEndian<uint8_t>(); break;
+                            case 0xc5: case 0xda: length = ReadBigEndian<uint16_t>(); break;
+                            case 0xc6: case 0xdb: length = ReadBigEndian<uint32_t>(); break;
+                            case 0xc7: length = ReadBigEndian<uint8_t>() + std::size_t{1}; break;
+                            case 0xc8: length = ReadBigEndian<uint16_t>() + std::size_t{1}; break;
+                            case 0xc9: length = ReadBigEndian<uint32_t>() + std::size_t{1}; break;
+                            case 0xd4: length = 2; break;
+                            case 0xd5: length = 3; break;
+                            case 0xd6: length = 5; break;
+                            case 0xd7: length = 9; break;
+                            case 0xd8: length = 17; break;
+                            case 0xdc: children = ReadBigEndian<uint16_t>(); break;
+                            case 0xdd: children = ReadBigEndian<uint32_t>(); break;
+                            case 0xde: children = ReadBigEndian<uint16_t>() * std::size_t{2}; break;
+                            case 0xdf: children = ReadBigEndian<uint32_t>() * std::size_t{2}; break;
+                            default:
+                                throw OpCoSerializerException("Invalid MessagePack format during deserialization");
+                        }
+                    }
+
+                    ReadBytes(length);
+                    if (children > Remaining())
+                    {
+                        throw OpCoSerializerException("Unexpected end of MessagePack data during deserialization");
+                    }
+
+                    pending += children;
+                }
+            }
+
+            /// Reads raw bytes.
+            /// @param size The number of bytes.
+            /// @returns The bytes, which remain in the buffer.
+            char const* ReadBytes(std::size_t size)
+            {
+                if (size > Remaining())
+                {
+                    throw OpCoSerializerException("Unexpected end of MessagePack data during deserialization");
+                }
+
+                auto bytes = _position;
+                _position += size;
+                return bytes;
+            }
+
+            /// Gets the number of bytes left to read.
+            /// @returns The number of bytes.
+            std::size_t Remaining() const
+            {
+                return static_cast<std::size_t>(_end - _position);
+            }
+
+            /// Starts reading the properties of an object.
+            /// @returns Whether or not all of its properties must be present.
+            /// @remarks Properties of nested objects are always required.
+            bool EnterObject()
+            {
+                auto required = _propertiesRequired || _depth != 0;
+                ++_depth;
+                return required;
+            }
+
+            /// Finishes reading the properties of an object.
+            void ExitObject()
+            {
+                --_depth;
+            }
+
+        private:
+            char const* _position;
+            char const* _end;
+            bool _propertiesRequired;
+            std::size_t _depth = 0;
+
+            unsigned char ReadByte()
+            {
+                return static_cast<unsigned char>(*ReadBytes(1));
+            }
+
+            template <typename T>
+            T ReadBigEndian()
+            {
+                T value;
+                std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+                return NativeToBigEndian(value);
+            }
+
+            template <typename T>
+            static T FromUnsigned(uint64_t value)
+            {
+                if constexpr (std::is_integral_v<T>)
+                {
+                    if (value > static_cast<uint64_t>(std::numeric_limits<T>::max()))
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+                }
+
+                return static_cast<T>(value);
+            }
+
+            template <typename T>
+            static T FromSigned(int64_t value)
+            {
+                if constexpr (std::is_integral_v<T>)
+                {
+                    using Limits = std::numeric_limits<T>;
+                    bool inRange;
+                    if constexpr (std::is_signed_v<T>)
+                    {
+                        inRange = value >= static_cast<int64_t>(Limits::min()) && value <= static_cast<int64_t>(Limits::max());
+                    }
+                    else
+                    {
+                        inRange = value >= 0 && static_cast<uint64_t>(value) <= static_cast<uint64_t>(Limits::max());
+                    }
+
+                    if (!inRange)
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+                }
+
+                return static_cast<T>(value);
+            }
+
+            [[noreturn]] static void ThrowUnexpected(char const* expected)
+            {
+                throw OpCoSerializerException(std::string("Unexpected MessagePack value during deserialization - expected ") + expected);
+            }
+    };
+}
+
+#endif // OPCOSERIALIZER_MSGPACK_STREAMS_HPP
@@ -0,0 +1,311 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_MSGPACK_TYPE_SERIALIZER_HPP
+#define OPCOSERIALIZER_MSGPACK_TYPE_SERIALIZER_HPP
+
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/MsgPack/MsgPackStreams.hpp"
+
+namespace OpCoSerializer::MsgPack
+{
+    template <typename T>
+    struct MsgPackTypeSerializer;
+
+    /// Writes the MessagePack encoding of the given value.
+    /// @tparam T The type of the value.
+    /// @param writer The writer.
+    /// @param value The value.
+    template <typename T>
+    void WriteMsgPack(MsgPackWriter& writer, T const& value)
+    {
+        MsgPackTypeSerializer<T>::Write(writer, value);
+    }
+
+    /// Reads a value into an existing instance, reusing its storage.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @param value The value to read into.
+    template <typename T>
+    void ReadMsgPack(MsgPackReader& reader, T& value)
+    {
+        MsgPackTypeSerializer<T>::Read(reader, value);
+    }
+
+    /// Reads a new value.
+    /// @remarks Types without a default constructor are constructed from the
+    /// values of their properties, otherwise a value initialized instance is
+    /// read into.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @returns The value.
+    template <typename T>
+    T ReadMsgPackValue(MsgPackReader& reader)
+    {
+        if constexpr (IsConstructedFromPropertiesV<T>)
+        {
+            return MsgPackTypeSerializer<T>::Construct(reader);
+        }
+        else
+        {
+            T value{};
+            ReadMsgPack(reader, value);
+            return value;
+        }
+    }
+
+    /// Provides MessagePack serialization and deserialization logic for a type.
+    /// @remarks Specialize this type in order to be able serialize or
+    /// deserialize any type of data. By default, this type will support:
+    /// - Numeric, boolean and enum types, in the smallest format that holds
+    /// the value.
+    /// - Types that have OpCoSerializer properties that are recursively
+    /// serializable, as maps keyed by property name. Unknown keys are skipped
+    /// when reading.
+    /// @tparam T The type.
+    template <typename T>
+    struct MsgPackTypeSerializer
+    {
+        /// Writes the given value.
+        /// @param writer The writer.
+        /// @param value The value.
+        static void Write(MsgPackWriter& writer, T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                writer.WriteMapHeader(PropertyCountV<T>);
+                ForProperty<T>([&](auto& property) {
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    using Type = typename std::remove_cvref<typename PropertyType::Type>::type;
+                    writer.WriteString(property.name, property.nameLength);
+                    WriteMsgPack<Type>(writer, value.*(property.member));
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                writer.WriteInteger(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                writer.WriteBool(value);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                writer.WriteFloat(value);
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "MsgPackTypeSerializer must be specialized for this type");
+                writer.WriteInteger(value);
+            }
+        }
+
+        /// Reads a value into an existing instance.
+        /// @param reader The reader.
+        /// @param value The value to read into.
+        static void Read(MsgPackReader& reader, T& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                ReadProperties(reader, [&](std::size_t index) {
+                    ForPropertyAt<T>(index, [&](auto& property) {
+                        ReadMsgPack(reader, value.*(property.member));
+                    });
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                value = static_cast<T>(reader.ReadNumber<std::underlying_type_t<T>>());
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                value = reader.ReadBool();
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T>, "MsgPackTypeSerializer must be specialized for this type");
+                value = reader.ReadNumber<T>();
+            }
+        }
+
+        /// Reads a value by constructing it once from the values of its
+        /// properties, for types without a default constructor.
+        /// @param reader The reader.
+        /// @returns The value.
+        static T Construct(MsgPackReader& reader)
+        {
+            PropertyValuesT<T> values;
+            auto required = ReadProperties(reader, [&](std::size_t index) {
+                ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                    auto& propertyValue = std::get<i>(values);
+                    using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                    propertyValue.emplace(ReadMsgPackValue<Type>(reader));
+                });
+            });
+
+            return ConstructFromProperties<T>(values, required);
+        }
+
+        private:
+            /// Reads the keys of a map, calling read with the index of each
+            /// property for it to read the value, and skipping unknown keys.
+            /// @returns Whether or not all properties were required.
+            template <typename TRead>
+            static bool ReadProperties(MsgPackReader& reader, TRead&& read)
+            {
+                auto size = reader.ReadMapHeader();
+                auto required = reader.EnterObject();
+                std::bitset<PropertyCountV<T>> seen;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    auto key = reader.ReadString();
+                    auto index = PropertyLookup<T>::Find(key.data(), key.size());
+                    if (index == PropertyLookup<T>::npos)
+                    {
+                        reader.Skip();
+                        continue;
+                    }
+
+                    seen.set(index);
+                    read(index);
+                }
+
+                if (required && !seen.all())
+                {
+                    std::size_t index = 0;
+                    ForProperty<T>([&](auto& property) {
+                        if (!seen.test(index++))
+                        {
+                            throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                        }
+                    });
+                }
+
+                reader.ExitObject();
+                return required;
+            }
+    };
+
+    /// Partial MsgPackTypeSerializer specialization for a vector of a given type.
+    /// @remarks Vectors are written as arrays of their elements.
+    template <typename TElement>
+    struct MsgPackTypeSerializer<std::vector<TElement>>
+    {
+        static void Write(MsgPackWriter& writer, std::vector<TElement> const& value)
+        {
+            writer.WriteArrayHeader(value.size());
+            for (auto const& element : value)
+            {
+                WriteMsgPack<TElement>(writer, element);
+            }
+        }
+
+        /// @remarks Existing elements are read into in place, reusing their
+        /// storage, and any left over are removed.
+        static void Read(MsgPackReader& reader, std::vector<TElement>& value)
+        {
+            // Every element takes at least one byte, so a corrupt size cannot
+            // reserve huge amounts of memory.
+            auto size = reader.ReadArrayHeader();
+            if (size > reader.Remaining())
+            {
+                throw OpCoSerializerException("Unexpected end of MessagePack data during deserialization");
+            }
+
+            if constexpr (IsConstructedFromPropertiesV<TElement>)
+            {
+                value.clear();
+            }
+
+            while (value.size() > size)
+            {
+                value.pop_back();
+            }
+
+            value.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if constexpr (std::is_same_v<TElement, bool>)
+                {
+                    auto element = reader.ReadBool();
+                    if (i < value.size())
+                    {
+                        value[i] = element;
+                    }
+                    else
+                    {
+                        value.push_back(element);
+                    }
+                }
+                else if constexpr (IsConstructedFromPropertiesV<TElement>)
+                {
+                    value.push_back(ReadMsgPackValue<TElement>(reader));
+                }
+                else if (i < value.size())
+                {
+                    ReadMsgPack(reader, value[i]);
+                }
+                else
+                {
+                    ReadMsgPack(reader, value.emplace_back());
+                }
+            }
+        }
+    };
+
+    /// MsgPackTypeSerializer specialization for a C++ string.
+    template <>
+    struct MsgPackTypeSerializer<std::string>
+    {
+        static void Write(MsgPackWriter& writer, std::string const& value)
+        {
+            writer.WriteString(value.data(), value.size());
+        }
+
+        static void Read(MsgPackReader& reader, std::string& value)
+        {
+            auto characters = reader.ReadString();
+            value.assign(characters.data(), characters.size());
+        }
+    };
+
+    /// MsgPackTypeSerializer specialization for a C++ string view.
+    /// @remarks Deserialized views refer to the characters in the buffer being
+    /// deserialized, so the buffer must outlive them.
+    template <>
+    struct MsgPackTypeSerializer<std::string_view>
+    {
+        static void Write(MsgPackWriter& writer, std::string_view const& value)
+        {
+            writer.WriteString(value.data(), value.size());
+        }
+
+        static void Read(MsgPackReader& reader, std::string_view& value)
+        {
+            value = reader.ReadString();
+        }
+    };
+}
+
+#endif // OPCOSERIALIZER_MSGPACK_TYPE_SERIALIZER_HPP
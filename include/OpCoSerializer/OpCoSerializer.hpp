@@ -22,6 +22,15 @@
 #define OPCOSERIALIZER_OPCOSERIALIZER_HPP
 
 // This header includes the entirety of the OpCoSerializer library.
+#include "OpCoSerializer/Binary/BinarySerializer.hpp"
+#include "OpCoSerializer/Cbor/CborSerializer.hpp"
+#include "OpCoSerializer/Flat/FlatSerializer.hpp"
+#include "OpCoSerializer/Flat/FlatView.hpp"
 #include "OpCoSerializer/Json/JsonSerializer.hpp"
+#include "OpCoSerializer/Json/NdjsonParallel.hpp"
+#include "OpCoSerializer/Json/NdjsonReader.hpp"
+#include "OpCoSerializer/Json/NdjsonWriter.hpp"
+#include "OpCoSerializer/MsgPack/MsgPackSerializer.hpp"
+#include "OpCoSerializer/Tagged/TaggedSerializer.hpp"
 
 #endif // OPCOSERIALIZER_OPCOSERIALIZER_HPP
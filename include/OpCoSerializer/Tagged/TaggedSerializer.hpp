@@ -0,0 +1,116 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_TAGGED_SERIALIZER_HPP
+#define OPCOSERIALIZER_TAGGED_SERIALIZER_HPP
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Tagged/TaggedStreams.hpp"
+#include "OpCoSerializer/Tagged/TaggedTypeSerializer.hpp"
+
+namespace OpCoSerializer::Tagged
+{
+    /// Configuration for a TaggedSerializer.
+    struct TaggedSerializerSettings final
+    {
+        /// Indicates when deserializing, if a member is not present,
+        /// whether or not an exception should be thrown. 
+        bool propertiesRequired = false;
+    };
+
+    /// Serializes objects to and from a tagged binary encoding, which has the
+    /// same wire format as Protocol Buffers.
+    /// @remarks Each property is written as a field identified by its field
+    /// number (see MakeProperty), followed by its value as a zigzag encoded
+    /// varint, a fixed size number, or a length delimited string or message.
+    /// Unknown fields are skipped when reading, so messages stay compatible
+    /// as properties are added and removed. The outermost value must have
+    /// properties.
+    class TaggedSerializer final
+    {
+        public:
+            /// Initializes a new instance of the TaggedSerializer type.
+            /// @param settings The settings to use.
+            explicit TaggedSerializer(TaggedSerializerSettings&& settings = TaggedSerializerSettings{})
+                : _settings(std::move(settings))
+            {
+            }
+
+            /// Serializes the given value.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @returns The serialized bytes.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            std::string Serialize(T const& value)
+            {
+                std::string serialized;
+                Serialize(value, serialized);
+                return serialized;
+            }
+
+            /// Serializes the given value into an existing string.
+            /// @remarks The string's contents are replaced, reusing its capacity.
+            /// @tparam T the type of the value to serialize.
+            /// @param value The value.
+            /// @param serialized The string to serialize to.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            void Serialize(T const& value, std::string& serialized)
+            {
+                serialized.clear();
+                TaggedWriter writer(serialized);
+                WriteTagged(writer, value);
+            }
+
+            /// Deserializes the bytes to a value of type T.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @returns The deserialized value.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            T Deserialize(std::string_view serialized)
+            {
+                TaggedReader reader(serialized, _settings.propertiesRequired);
+                return ReadTaggedValue<T>(reader);
+            }
+
+            /// Deserializes the bytes into an existing value, overwriting its
+            /// members in place and reusing their storage.
+            /// @tparam T the type of the value to deserialize to.
+            /// @param serialized The serialized bytes.
+            /// @param target The value to deserialize into.
+            template <typename T>
+                requires HasSerializablePropertiesV<T>
+            void DeserializeInto(std::string_view serialized, T& target)
+            {
+                TaggedReader reader(serialized, _settings.propertiesRequired);
+                ReadTagged(reader, target);
+            }
+
+        private:
+            TaggedSerializerSettings _settings;
+    };
+}
+
+#endif // OPCOSERIALIZER_TAGGED_SERIALIZER_HPP
@@ -0,0 +1,326 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_TAGGED_STREAMS_HPP
+#define OPCOSERIALIZER_TAGGED_STREAMS_HPP
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include "OpCoSerializer/Common.hpp"
+
+namespace OpCoSerializer::Tagged
+{
+    /// How the value of a field is encoded, in the low three bits of its tag.
+    enum class TaggedWireType : uint8_t
+    {
+        Varint = 0,
+        Fixed64 = 1,
+        LengthDelimited = 2,
+        Fixed32 = 5
+    };
+
+    /// The tag of a field, which precedes its value.
+    struct TaggedFieldTag final
+    {
+        /// The field number.
+        uint32_t number;
+
+        /// How the value is encoded.
+        TaggedWireType type;
+    };
+
+    /// The largest field number a tag can hold.
+    uint32_t constexpr TaggedMaxFieldNumber = (1u << 29) - 1;
+
+    /// Maps signed integers to unsigned ones so that numbers of small magnitude
+    /// have short varints, i.e. 0, -1, 1, -2 to 0, 1, 2, 3.
+    /// @param value The signed integer.
+    /// @returns The unsigned integer.
+    constexpr uint64_t ZigZagEncode(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /// Reverses ZigZagEncode.
+    /// @param value The unsigned integer.
+    /// @returns The signed integer.
+    constexpr int64_t ZigZagDecode(uint64_t value) noexcept
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /// Appends tagged fields and their values to a string.
+    /// @remarks Varints hold seven bits per byte, least significant first, and
+    /// fixed size numbers are little endian, as in Protocol Buffers.
+    class TaggedWriter final
+    {
+        public:
+            /// Initializes a new instance of the TaggedWriter type.
+            /// @param output The string to append to.
+            explicit TaggedWriter(std::string& output)
+                : _output(output)
+            {
+            }
+
+            /// Appends the tag of a field.
+            /// @param number The field number.
+            /// @param type How the value is encoded.
+            void WriteTag(uint32_t number, TaggedWireType type)
+            {
+                WriteVarint((static_cast<uint64_t>(number) << 3) | static_cast<uint64_t>(type));
+            }
+
+            /// Appends a varint.
+            /// @param value The value.
+            void WriteVarint(uint64_t value)
+            {
+                char bytes[10];
+                std::size_t count = 0;
+                while (value >= 0x80)
+                {
+                    bytes[count++] = static_cast<char>((value & 0x7f) | 0x80);
+                    value >>= 7;
+                }
+
+                bytes[count++] = static_cast<char>(value);
+                _output.append(bytes, count);
+            }
+
+            /// Appends a fixed size number in little endian byte order.
+            /// @param value The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            void WriteFixed(T value)
+            {
+                auto littleEndian = NativeToLittleEndian(value);
+                WriteBytes(&littleEndian, sizeof(T));
+            }
+
+            /// Appends raw bytes.
+            /// @param data The bytes.
+            /// @param size The number of bytes.
+            void WriteBytes(void const* data, std::size_t size)
+            {
+                _output.append(static_cast<char const*>(data), size);
+            }
+
+            /// Starts a length delimited value, which must be finished by
+            /// calling EndLengthDelimited once it has been written.
+            /// @returns The position of the length, for EndLengthDelimited.
+            std::size_t BeginLengthDelimited()
+            {
+                // Most values are shorter than 128 bytes, so one byte is
+                // reserved for the length and moved along if it needs more.
+                auto position = _output.size();
+                _output.push_back('\0');
+                return position;
+            }
+
+            /// Finishes a length delimited value by writing its length.
+            /// @param position The position returned by BeginLengthDelimited.
+            void EndLengthDelimited(std::size_t position)
+            {
+                auto length = static_cast<uint64_t>(_output.size() - position - 1);
+                std::size_t size = 1;
+                for (auto remaining = length >> 7; remaining != 0; remaining >>= 7)
+                {
+                    ++size;
+                }
+
+                if (size > 1)
+                {
+                    _output.insert(position + 1, size - 1, '\0');
+                }
+
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    auto byte = static_cast<unsigned char>(length & 0x7f);
+                    length >>= 7;
+                    _output[position + i] = static_cast<char>(i + 1 < size ? byte | 0x80 : byte);
+                }
+            }
+
+        private:
+            std::string& _output;
+    };
+
+    /// Reads tagged fields and their values from a buffer, as written by a
+    /// TaggedWriter.
+    /// @remarks Every read is bounds checked, throwing an OpCoSerializerException
+    /// rather than reading beyond the end of the buffer, or of the length
+    /// delimited value being read.
+    class TaggedReader final
+    {
+        public:
+            /// Initializes a new instance of the TaggedReader type.
+            /// @param input The buffer. Must outlive the reader.
+            /// @param propertiesRequired Whether or not all properties of each
+            /// message must be present.
+            explicit TaggedReader(std::string_view input, bool propertiesRequired = false)
+                : _position(input.data()),
+                  _end(input.data() + input.size()),
+                  _propertiesRequired(propertiesRequired)
+            {
+            }
+
+            /// Reads the tag of a field.
+            /// @returns The tag.
+            TaggedFieldTag ReadTag()
+            {
+                auto tag = ReadVarint();
+                auto number = tag >> 3;
+                if (number == 0 || number > TaggedMaxFieldNumber)
+                {
+                    throw OpCoSerializerException("Invalid field number in tagged data during deserialization");
+                }
+
+                return TaggedFieldTag{ static_cast<uint32_t>(number), static_cast<TaggedWireType>(tag & 0x07) };
+            }
+
+            /// Reads a varint.
+            /// @returns The value.
+            uint64_t ReadVarint()
+            {
+                uint64_t value = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7)
+                {
+                    auto byte = static_cast<unsigned char>(*ReadBytes(1));
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return value;
+                    }
+                }
+
+                throw OpCoSerializerException("Invalid varint in tagged data during deserialization");
+            }
+
+            /// Reads a fixed size number in little endian byte order.
+            /// @returns The number.
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            T ReadFixed()
+            {
+                T value;
+                std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+                return NativeToLittleEndian(value);
+            }
+
+            /// Reads raw bytes.
+            /// @param size The number of bytes.
+            /// @returns The bytes, which remain in the buffer.
+            char const* ReadBytes(std::size_t size)
+            {
+                if (size > Remaining())
+                {
+                    throw OpCoSerializerException("Unexpected end of tagged data during deserialization");
+                }
+
+                auto bytes = _position;
+                _position += size;
+                return bytes;
+            }
+
+            /// Reads the length of a length delimited value, and limits reading
+            /// to the value until PopLimit is called.
+            /// @returns The previous limit, for PopLimit.
+            char const* PushLimit()
+            {
+                auto length = ReadVarint();
+                if (length > Remaining())
+                {
+                    throw OpCoSerializerException("Unexpected end of tagged data during deserialization");
+                }
+
+                auto end = _end;
+                _end = _position + length;
+                return end;
+            }
+
+            /// Restores the limit from before PushLimit, once all of the length
+            /// delimited value has been read.
+            /// @param end The limit returned by PushLimit.
+            void PopLimit(char const* end)
+            {
+                if (_position != _end)
+                {
+                    throw OpCoSerializerException("Unexpected tagged data after the end of a value during deserialization");
+                }
+
+                _end = end;
+            }
+
+            /// Skips over the value of a field.
+            /// @param type How the value is encoded.
+            void Skip(TaggedWireType type)
+            {
+                switch (type)
+                {
+                    case TaggedWireType::Varint:
+                        ReadVarint();
+                        break;
+                    case TaggedWireType::Fixed64:
+                        ReadBytes(8);
+                        break;
+                    case TaggedWireType::Fixed32:
+                        ReadBytes(4);
+                        break;
+                    case TaggedWireType::LengthDelimited:
+                    {
+                        auto length = ReadVarint();
+                        if (length > Remaining())
+                        {
+                            throw OpCoSerializerException("Unexpected end of tagged data during deserialization");
+                        }
+
+                        ReadBytes(static_cast<std::size_t>(length));
+                        break;
+                    }
+                    default:
+                        throw OpCoSerializerException("Unsupported wire type in tagged data during deserialization");
+                }
+            }
+
+            /// Gets the number of bytes left to read within the current limit.
+            /// @returns The number of bytes.
+            std::size_t Remaining() const
+            {
+                return static_cast<std::size_t>(_end - _position);
+            }
+
+            /// Whether or not all properties of a message must be present.
+            /// @remarks Applies to nested messages as well as the outermost
+            /// one, so that fields can be added to any message while older
+            /// data can still be read.
+            bool PropertiesRequired() const
+            {
+                return _propertiesRequired;
+            }
+
+        private:
+            char const* _position;
+            char const* _end;
+            bool _propertiesRequired;
+    };
+}
+
+#endif // OPCOSERIALIZER_TAGGED_STREAMS_HPP
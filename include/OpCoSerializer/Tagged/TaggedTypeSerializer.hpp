@@ -0,0 +1,689 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPCOSERIALIZER_TAGGED_TYPE_SERIALIZER_HPP
+#define OPCOSERIALIZER_TAGGED_TYPE_SERIALIZER_HPP
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "OpCoSerializer/Common.hpp"
+#include "OpCoSerializer/Tagged/TaggedStreams.hpp"
+
+namespace OpCoSerializer::Tagged
+{
+    template <typename T>
+    struct TaggedTypeSerializer;
+
+    /// Checks whether or not T is a vector, which is written as a repeated field.
+    template <typename T>
+    struct IsTaggedRepeated : std::false_type
+    {
+    };
+
+    template <typename TElement>
+    struct IsTaggedRepeated<std::vector<TElement>> : std::true_type
+    {
+    };
+
+    /// Helper for the value of IsTaggedRepeated<T>.
+    template <typename T>
+    bool constexpr IsTaggedRepeatedV = IsTaggedRepeated<T>::value;
+
+    /// Checks whether or not repeated values of T are packed together into a
+    /// single length delimited field, i.e. T is not length delimited itself.
+    template <typename T>
+    bool constexpr IsTaggedPackedV = !IsTaggedRepeatedV<T>
+        && TaggedTypeSerializer<T>::WireType != TaggedWireType::LengthDelimited;
+
+    /// Writes the body of a value, without its tag or length.
+    /// @tparam T The type of the value.
+    /// @param writer The writer.
+    /// @param value The value.
+    template <typename T>
+    void WriteTagged(TaggedWriter& writer, T const& value)
+    {
+        TaggedTypeSerializer<T>::Write(writer, value);
+    }
+
+    /// Reads the body of a value into an existing instance, reusing its storage.
+    /// @tparam T The type of the value.
+    /// @param reader The reader, limited to the value if it is length delimited.
+    /// @param value The value to read into.
+    template <typename T>
+    void ReadTagged(TaggedReader& reader, T& value)
+    {
+        TaggedTypeSerializer<T>::Read(reader, value);
+    }
+
+    /// Reads the body of a new value.
+    /// @remarks Types without a default constructor are constructed from the
+    /// values of their properties, otherwise a value initialized instance is
+    /// read into.
+    /// @tparam T The type of the value.
+    /// @param reader The reader, limited to the value if it is length delimited.
+    /// @returns The value.
+    template <typename T>
+    T ReadTaggedValue(TaggedReader& reader)
+    {
+        if constexpr (IsConstructedFromPropertiesV<T>)
+        {
+            return TaggedTypeSerializer<T>::Construct(reader);
+        }
+        else
+        {
+            T value{};
+            ReadTagged(reader, value);
+            return value;
+        }
+    }
+
+    /// Writes a field, i.e. the tag followed by the value.
+    /// @tparam T The type of the value.
+    /// @param writer The writer.
+    /// @param number The field number.
+    /// @param value The value.
+    template <typename T>
+    void WriteTaggedField(TaggedWriter& writer, uint32_t number, T const& value)
+    {
+        auto constexpr wireType = TaggedTypeSerializer<T>::WireType;
+        writer.WriteTag(number, wireType);
+        if constexpr (wireType == TaggedWireType::LengthDelimited)
+        {
+            auto position = writer.BeginLengthDelimited();
+            WriteTagged(writer, value);
+            writer.EndLengthDelimited(position);
+        }
+        else
+        {
+            WriteTagged(writer, value);
+        }
+    }
+
+    /// Writes a repeated field. Nothing is written for an empty vector.
+    /// @remarks Numbers, booleans and enums are packed into a single length
+    /// delimited field. Other elements are written as a field each, with
+    /// vectors nested in a message whose field 1 holds their elements.
+    template <typename TElement>
+    void WriteTaggedField(TaggedWriter& writer, uint32_t number, std::vector<TElement> const& value)
+    {
+        if (value.empty())
+        {
+            return;
+        }
+
+        if constexpr (IsTaggedPackedV<TElement>)
+        {
+            writer.WriteTag(number, TaggedWireType::LengthDelimited);
+            auto position = writer.BeginLengthDelimited();
+            if constexpr (std::is_floating_point_v<TElement> && std::endian::native == std::endian::little)
+            {
+                writer.WriteBytes(value.data(), value.size() * sizeof(TElement));
+            }
+            else
+            {
+                for (auto const& element : value)
+                {
+                    WriteTagged<TElement>(writer, element);
+                }
+            }
+
+            writer.EndLengthDelimited(position);
+        }
+        else if constexpr (IsTaggedRepeatedV<TElement>)
+        {
+            for (auto const& element : value)
+            {
+                writer.WriteTag(number, TaggedWireType::LengthDelimited);
+                auto position = writer.BeginLengthDelimited();
+                WriteTaggedField(writer, 1, element);
+                writer.EndLengthDelimited(position);
+            }
+        }
+        else
+        {
+            for (auto const& element : value)
+            {
+                WriteTaggedField(writer, number, element);
+            }
+        }
+    }
+
+    /// Checks that a field was written with the wire type of T.
+    /// @tparam T The type of the value.
+    /// @param type The wire type of the field.
+    template <typename T>
+    void CheckTaggedWireType(TaggedWireType type)
+    {
+        if (type != TaggedTypeSerializer<T>::WireType)
+        {
+            throw OpCoSerializerException("Unexpected wire type in tagged data during deserialization");
+        }
+    }
+
+    /// Reads the value of a field into an existing instance.
+    /// @tparam T The type of the value.
+    /// @param reader The reader.
+    /// @param type The wire type of the field.
+    /// @param value The value to read into.
+    template <typename T>
+    void ReadTaggedField(TaggedReader& reader, TaggedWireType type, T& value)
+    {
+        CheckTaggedWireType<T>(type);
+        if constexpr (TaggedTypeSerializer<T>::WireType == TaggedWireType::LengthDelimited)
+        {
+            auto end = reader.PushLimit();
+            ReadTagged(reader, value);
+            reader.PopLimit(end);
+        }
+        else
+        {
+            ReadTagged(reader, value);
+        }
+    }
+
+    /// Reads the value of a field as a new value.
+    template <typename T>
+    T ReadTaggedFieldValue(TaggedReader& reader, TaggedWireType type)
+    {
+        CheckTaggedWireType<T>(type);
+        auto end = reader.PushLimit();
+        auto value = ReadTaggedValue<T>(reader);
+        reader.PopLimit(end);
+        return value;
+    }
+
+    /// Reads the value of a field into a property value being gathered in
+    /// order to construct a type without a default constructor.
+    template <typename T>
+    void ReadTaggedField(TaggedReader& reader, TaggedWireType type, std::optional<T>& value)
+    {
+        if constexpr (IsConstructedFromPropertiesV<T>)
+        {
+            value.emplace(ReadTaggedFieldValue<T>(reader, type));
+        }
+        else
+        {
+            if (!value)
+            {
+                value.emplace();
+            }
+
+            ReadTaggedField(reader, type, *value);
+        }
+    }
+
+    /// Reads one occurrence of a repeated field, reusing the existing
+    /// elements from count onwards.
+    /// @remarks Both packed and unpacked numbers are accepted.
+    /// @param count The number of elements read so far, which is updated.
+    template <typename TElement>
+    void ReadTaggedField(TaggedReader& reader, TaggedWireType type, std::vector<TElement>& value, std::size_t& count)
+    {
+        auto next = [&](auto&& read) {
+            if constexpr (std::is_same_v<TElement, bool>)
+            {
+                bool element = false;
+                read(element);
+                if (count < value.size())
+                {
+                    value[count] = element;
+                }
+                else
+                {
+                    value.push_back(element);
+                }
+            }
+            else if (count < value.size())
+            {
+                read(value[count]);
+            }
+            else
+            {
+                read(value.emplace_back());
+            }
+
+            ++count;
+        };
+
+        if constexpr (IsTaggedPackedV<TElement>)
+        {
+            if (type == TaggedWireType::LengthDelimited)
+            {
+                auto end = reader.PushLimit();
+                if constexpr (std::is_floating_point_v<TElement> && std::endian::native == std::endian::little)
+                {
+                    auto size = reader.Remaining();
+                    if (size % sizeof(TElement) != 0)
+                    {
+                        throw OpCoSerializerException("Invalid packed field length in tagged data during deserialization");
+                    }
+
+                    value.resize(count + size / sizeof(TElement));
+                    std::memcpy(value.data() + count, reader.ReadBytes(size), size);
+                    count += size / sizeof(TElement);
+                }
+                else
+                {
+                    while (reader.Remaining() != 0)
+                    {
+                        next([&](auto& element) { ReadTagged(reader, element); });
+                    }
+                }
+
+                reader.PopLimit(end);
+                return;
+            }
+
+            next([&](auto& element) { ReadTaggedField(reader, type, element); });
+        }
+        else if constexpr (IsConstructedFromPropertiesV<TElement>)
+        {
+            while (value.size() > count)
+            {
+                value.pop_back();
+            }
+
+            value.push_back(ReadTaggedFieldValue<TElement>(reader, type));
+            ++count;
+        }
+        else if constexpr (IsTaggedRepeatedV<TElement>)
+        {
+            if (type != TaggedWireType::LengthDelimited)
+            {
+                throw OpCoSerializerException("Unexpected wire type in tagged data during deserialization");
+            }
+
+            next([&](auto& element) {
+                auto end = reader.PushLimit();
+                std::size_t elementCount = 0;
+                while (reader.Remaining() != 0)
+                {
+                    auto tag = reader.ReadTag();
+                    if (tag.number == 1)
+                    {
+                        ReadTaggedField(reader, tag.type, element, elementCount);
+                    }
+                    else
+                    {
+                        reader.Skip(tag.type);
+                    }
+                }
+
+                while (element.size() > elementCount)
+                {
+                    element.pop_back();
+                }
+
+                reader.PopLimit(end);
+            });
+        }
+        else
+        {
+            next([&](auto& element) { ReadTaggedField(reader, type, element); });
+        }
+    }
+
+    /// The field numbers of the properties of T, which are given through
+    /// MakeProperty or are otherwise the property's index plus one.
+    /// @tparam T The type with the properties.
+    template <typename T>
+    class TaggedFieldNumbers final
+    {
+        public:
+            /// The index returned for field numbers that are not properties of T.
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            /// The field number of each property.
+            static constexpr auto numbers = []() {
+                std::array<uint32_t, PropertyCountV<T>> numbers{};
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    numbers[index] = property.fieldNumber != 0 ? property.fieldNumber : static_cast<uint32_t>(index + 1);
+                    ++index;
+                });
+
+                return numbers;
+            }();
+
+            static_assert(
+                []() {
+                    for (std::size_t i = 0; i < numbers.size(); ++i)
+                    {
+                        if (numbers[i] == 0 || numbers[i] > TaggedMaxFieldNumber)
+                        {
+                            return false;
+                        }
+
+                        for (std::size_t j = 0; j < i; ++j)
+                        {
+                            if (numbers[i] == numbers[j])
+                            {
+                                return false;
+                            }
+                        }
+                    }
+
+                    return true;
+                }(),
+                "Field numbers must be unique, and between 1 and 2^29 - 1");
+
+            /// Finds the index of the property with the given field number,
+            /// through a table when the field numbers are small.
+            /// @param number The field number.
+            /// @returns The property index, or npos if there is no such property.
+            static std::size_t Find(uint32_t number)
+            {
+                if constexpr (maxNumber < 256)
+                {
+                    return number <= maxNumber ? table[number] : npos;
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < numbers.size(); ++i)
+                    {
+                        if (numbers[i] == number)
+                        {
+                            return i;
+                        }
+                    }
+
+                    return npos;
+                }
+            }
+
+        private:
+            static constexpr uint32_t maxNumber = []() {
+                uint32_t max = 0;
+                for (auto number : numbers)
+                {
+                    max = number > max ? number : max;
+                }
+
+                return max;
+            }();
+
+            static constexpr auto table = []() {
+                std::array<std::size_t, maxNumber < 256 ? maxNumber + 1 : 0> table{};
+                table.fill(npos);
+                if constexpr (maxNumber < 256)
+                {
+                    for (std::size_t i = 0; i < numbers.size(); ++i)
+                    {
+                        table[numbers[i]] = i;
+                    }
+                }
+
+                return table;
+            }();
+    };
+
+    /// Provides tagged serialization and deserialization logic for a type.
+    /// @remarks Specialize this type in order to be able serialize or
+    /// deserialize any type of data, giving the WireType its body is written
+    /// with. By default, this type will support:
+    /// - Integer, boolean and enum types, as varints. Signed integers are zigzag
+    /// encoded, so small negative numbers are as short as small positive ones.
+    /// - Floats and doubles, as fixed 32 and 64 bit numbers.
+    /// - Types that have OpCoSerializer properties that are recursively
+    /// serializable, as length delimited messages of fields identified by
+    /// field number. Unknown fields are skipped when reading.
+    /// @tparam T The type.
+    template <typename T>
+    struct TaggedTypeSerializer
+    {
+        /// How the body of a value is encoded.
+        static TaggedWireType constexpr WireType = HasSerializablePropertiesV<T>
+            ? TaggedWireType::LengthDelimited
+            : std::is_same_v<T, float>
+                ? TaggedWireType::Fixed32
+                : std::is_same_v<T, double> ? TaggedWireType::Fixed64 : TaggedWireType::Varint;
+
+        /// Writes the body of the given value.
+        /// @param writer The writer.
+        /// @param value The value.
+        static void Write(TaggedWriter& writer, T const& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                std::size_t index = 0;
+                ForProperty<T>([&](auto& property) {
+                    WriteTaggedField(writer, TaggedFieldNumbers<T>::numbers[index++], value.*(property.member));
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                WriteInteger(writer, static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                static_assert(sizeof(T) == 4 || sizeof(T) == 8, "TaggedTypeSerializer must be specialized for this type");
+                writer.WriteFixed(value);
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "TaggedTypeSerializer must be specialized for this type");
+                WriteInteger(writer, value);
+            }
+        }
+
+        /// Reads the body of a value into an existing instance.
+        /// @param reader The reader.
+        /// @param value The value to read into.
+        static void Read(TaggedReader& reader, T& value)
+        {
+            if constexpr (HasSerializablePropertiesV<T>)
+            {
+                ReadMessage(reader, [&](auto i) -> auto& {
+                    auto constexpr property = std::get<i>(T::SerializerProperties());
+                    return value.*(property.member);
+                });
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                value = static_cast<T>(ReadInteger<std::underlying_type_t<T>>(reader));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                value = reader.ReadFixed<T>();
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "TaggedTypeSerializer must be specialized for this type");
+                value = ReadInteger<T>(reader);
+            }
+        }
+
+        /// Reads the body of a value by constructing it once from the values
+        /// of its properties, for types without a default constructor.
+        /// @param reader The reader.
+        /// @returns The value.
+        static T Construct(TaggedReader& reader)
+        {
+            PropertyValuesT<T> values;
+            auto required = ReadMessage(reader, [&](auto i) -> auto& {
+                auto& propertyValue = std::get<i>(values);
+                using Type = typename std::remove_cvref_t<decltype(propertyValue)>::value_type;
+                if constexpr (IsTaggedRepeatedV<Type>)
+                {
+                    // Repeated fields are empty unless they occur.
+                    if (!propertyValue)
+                    {
+                        propertyValue.emplace();
+                    }
+
+                    return *propertyValue;
+                }
+                else
+                {
+                    return propertyValue;
+                }
+            });
+
+            return ConstructFromProperties<T>(values, required);
+        }
+
+        private:
+            /// Reads the fields of a message, skipping unknown fields.
+            /// @param field Gets the target for the property with the given
+            /// index, as an integral constant.
+            /// @returns Whether or not all properties were required.
+            template <typename TField>
+            static bool ReadMessage(TaggedReader& reader, TField&& field)
+            {
+                auto required = reader.PropertiesRequired();
+                std::array<std::size_t, PropertyCountV<T>> counts{};
+                std::bitset<PropertyCountV<T>> seen;
+                while (reader.Remaining() != 0)
+                {
+                    auto tag = reader.ReadTag();
+                    auto index = TaggedFieldNumbers<T>::Find(tag.number);
+                    if (index == TaggedFieldNumbers<T>::npos)
+                    {
+                        reader.Skip(tag.type);
+                        continue;
+                    }
+
+                    seen.set(index);
+                    ForIndexAt<PropertyCountV<T>>(index, [&](auto i) {
+                        auto& target = field(i);
+                        if constexpr (IsTaggedRepeatedV<std::remove_cvref_t<decltype(target)>>)
+                        {
+                            ReadTaggedField(reader, tag.type, target, counts[i]);
+                        }
+                        else
+                        {
+                            ReadTaggedField(reader, tag.type, target);
+                        }
+                    });
+                }
+
+                // Repeated fields only hold the elements that occurred, and
+                // are not required as nothing is written for empty vectors.
+                ForSequence(std::make_index_sequence<PropertyCountV<T>>{}, [&](auto i) {
+                    auto constexpr property = std::get<i>(T::SerializerProperties());
+                    using PropertyType = typename std::remove_cvref<decltype(property)>::type;
+                    if constexpr (IsTaggedRepeatedV<std::remove_cvref_t<typename PropertyType::Type>>)
+                    {
+                        auto& target = field(i);
+                        while (target.size() > counts[i])
+                        {
+                            target.pop_back();
+                        }
+                    }
+                    else if (required && !seen.test(i))
+                    {
+                        throw OpCoSerializerException(std::string("Missing property during deserialization - ") + property.name);
+                    }
+                });
+
+                return required;
+            }
+
+            template <typename TInteger>
+            static void WriteInteger(TaggedWriter& writer, TInteger value)
+            {
+                if constexpr (std::is_signed_v<TInteger>)
+                {
+                    writer.WriteVarint(ZigZagEncode(static_cast<int64_t>(value)));
+                }
+                else
+                {
+                    writer.WriteVarint(static_cast<uint64_t>(value));
+                }
+            }
+
+            template <typename TInteger>
+            static TInteger ReadInteger(TaggedReader& reader)
+            {
+                using Limits = std::numeric_limits<TInteger>;
+                auto varint = reader.ReadVarint();
+                if constexpr (std::is_same_v<TInteger, bool>)
+                {
+                    return varint != 0;
+                }
+                else if constexpr (std::is_signed_v<TInteger>)
+                {
+                    auto value = ZigZagDecode(varint);
+                    if (value < static_cast<int64_t>(Limits::min()) || value > static_cast<int64_t>(Limits::max()))
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+
+                    return static_cast<TInteger>(value);
+                }
+                else
+                {
+                    if (varint > static_cast<uint64_t>(Limits::max()))
+                    {
+                        throw OpCoSerializerException("Integer out of range during deserialization");
+                    }
+
+                    return static_cast<TInteger>(varint);
+                }
+            }
+    };
+
+    /// TaggedTypeSerializer specialization for a C++ string.
+    template <>
+    struct TaggedTypeSerializer<std::string>
+    {
+        static TaggedWireType constexpr WireType = TaggedWireType::LengthDelimited;
+
+        static void Write(TaggedWriter& writer, std::string const& value)
+        {
+            writer.WriteBytes(value.data(), value.size());
+        }
+
+        static void Read(TaggedReader& reader, std::string& value)
+        {
+            auto size = reader.Remaining();
+            value.assign(reader.ReadBytes(size), size);
+        }
+    };
+
+    /// TaggedTypeSerializer specialization for a C++ string view.
+    /// @remarks Deserialized views refer to the characters in the buffer being
+    /// deserialized, so the buffer must outlive them.
+    template <>
+    struct TaggedTypeSerializer<std::string_view>
+    {
+        static TaggedWireType constexpr WireType = TaggedWireType::LengthDelimited;
+
+        static void Write(TaggedWriter& writer, std::string_view const& value)
+        {
+            writer.WriteBytes(value.data(), value.size());
+        }
+
+        static void Read(TaggedReader& reader, std::string_view& value)
+        {
+            auto size = reader.Remaining();
+            value = std::string_view(reader.ReadBytes(size), size);
+        }
+    };
+}
+
+#endif // OPCOSERIALIZER_TAGGED_TYPE_SERIALIZER_HPP
@@ -0,0 +1,417 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    std::atomic<std::size_t> allocations{0};
+}
+
+// GCC pairs operator new with operator delete when they are inlined into a
+// caller, and warns that the replacements free memory from operator new,
+// though both use malloc and free.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (auto pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+    /// Counts the heap allocations made during its lifetime.
+    class AllocationCounter final
+    {
+        public:
+            AllocationCounter()
+                : _start(allocations.load())
+            {
+            }
+
+            std::size_t Count() const
+            {
+                return allocations.load() - _start;
+            }
+
+        private:
+            std::size_t _start;
+    };
+
+    struct Inner final
+    {
+        std::string label;
+        std::vector<int> values;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Inner::label, "label"),
+                MakeProperty(&Inner::values, "values")
+            );
+        };
+    };
+
+    struct Outer final
+    {
+        int id = 0;
+        std::string name;
+        std::vector<double> readings;
+        std::vector<Inner> inners;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Outer::id, "id"),
+                MakeProperty(&Outer::name, "name"),
+                MakeProperty(&Outer::readings, "readings"),
+                MakeProperty(&Outer::inners, "inners")
+            );
+        };
+    };
+
+    Outer MakeOuter()
+    {
+        return Outer {
+            42,
+            "a name which is too long for the small string optimization",
+            { 1.5, 2.5, 3.5 },
+            {
+                Inner { "another label which does not fit in a small string", { 1, 2, 3 } },
+                Inner { "yet another label which does not fit in a small string", { 4, 5 } }
+            }
+        };
+    }
+}
+
+TEST(Allocations, WriteDoesNotAllocateOnceWarm)
+{
+    auto value = MakeOuter();
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    WriteJson(writer, value);
+    buffer.Clear();
+    writer.Reset(buffer);
+
+    AllocationCounter counter;
+    WriteJson(writer, value);
+
+    ASSERT_EQ(0u, counter.Count());
+}
+
+TEST(Allocations, DocumentSerializeDoesNotCopyProperties)
+{
+    auto value = MakeOuter();
+    rapidjson::Document document;
+    JsonTypeSerializer<Outer>::Serialize(document, value);
+
+    // Everything is allocated from the document's memory pool, which already
+    // has room, rather than copying members onto the heap.
+    AllocationCounter counter;
+    JsonTypeSerializer<Outer>::Serialize(document, value);
+
+    ASSERT_EQ(0u, counter.Count());
+}
+
+namespace
+{
+    struct Point final
+    {
+        double x = 0.0;
+        double y = 0.0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Point::x, "x"),
+                MakeProperty(&Point::y, "y")
+            );
+        };
+    };
+
+    struct Segment final
+    {
+        int id = 0;
+        Point start;
+        Point end;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Segment::id, "id"),
+                MakeProperty(&Segment::start, "start"),
+                MakeProperty(&Segment::end, "end")
+            );
+        };
+    };
+}
+
+TEST(Allocations, SerializeIntoStringDoesNotAllocateOnceWarm)
+{
+    JsonSerializer serializer{};
+    auto value = MakeOuter();
+    std::string serialized;
+    serializer.Serialize(value, serialized);
+
+    AllocationCounter counter;
+    serializer.Serialize(value, serialized);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ(serializer.Serialize(value), serialized);
+}
+
+TEST(Allocations, SerializeAllocatesOnlyTheOutput)
+{
+    JsonSerializer serializer{};
+    auto value = MakeOuter();
+    auto expected = serializer.Serialize(value);
+
+    AllocationCounter counter;
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(1u, counter.Count());
+    ASSERT_EQ(expected, serialized);
+}
+
+TEST(Allocations, PrettySerializeIntoStringDoesNotAllocateOnceWarm)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .pretty = true }};
+    auto value = MakeOuter();
+    std::string serialized;
+    serializer.Serialize(value, serialized);
+
+    AllocationCounter counter;
+    serializer.Serialize(value, serialized);
+
+    ASSERT_EQ(0u, counter.Count());
+}
+
+TEST(Allocations, DeserializeDoesNotAllocateOnceWarm)
+{
+    JsonSerializer serializer{};
+    std::string serialized{"{\"id\":3,\"start\":{\"x\":1.5,\"y\":2},\"unknown\":[1,{}],\"end\":{\"x\":-1,\"y\":0.25}}"};
+    serializer.Deserialize<Segment>(serialized);
+
+    AllocationCounter counter;
+    auto deserialized = serializer.Deserialize<Segment>(serialized);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ(3, deserialized.id);
+    ASSERT_EQ(0.25, deserialized.end.y);
+}
+
+TEST(Allocations, ApplyDeltaMemoryStaysBounded)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    // rapidjson allocates its memory pools with std::malloc rather than
+    // operator new, so the heap in use is measured instead.
+    JsonSerializer serializer{};
+    auto previous = MakeOuter();
+    auto current = previous;
+    current.readings.assign(500, 0.125);
+    auto delta = serializer.SerializeDelta(previous, current);
+    auto target = previous;
+    serializer.ApplyDelta(delta, target);
+
+    auto before = mallinfo2().uordblks;
+    for (auto i = 0; i < 2000; ++i)
+    {
+        target = previous;
+        serializer.ApplyDelta(delta, target);
+    }
+
+    auto after = mallinfo2().uordblks;
+
+    ASSERT_LT(after, before + 1024 * 1024);
+    ASSERT_EQ(current.readings, target.readings);
+#else
+    GTEST_SKIP() << "Measuring the heap in use requires glibc";
+#endif
+}
+
+TEST(Allocations, NdjsonNextDoesNotAllocateOnceWarm)
+{
+    auto value = MakeOuter().inners[0];
+    NdjsonWriter<Inner> writer;
+    for (auto i = 0; i < 3; ++i)
+    {
+        writer.Write(value);
+    }
+
+    NdjsonReader<Inner> reader(writer.View());
+    Inner record;
+    reader.Next(record);
+
+    AllocationCounter counter;
+    reader.Next(record);
+    reader.Next(record);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ(value.label, record.label);
+    ASSERT_EQ(value.values, record.values);
+}
+
+TEST(Allocations, NdjsonWriteToStreamDoesNotAllocateOnceWarm)
+{
+    std::FILE* file = std::tmpfile();
+    auto value = MakeOuter();
+    {
+        NdjsonWriter<Outer> writer(file);
+        while (writer.Count() < 1000)
+        {
+            writer.Write(value);
+        }
+
+        AllocationCounter counter;
+        for (auto i = 0; i < 1000; ++i)
+        {
+            writer.Write(value);
+        }
+
+        ASSERT_EQ(0u, counter.Count());
+    }
+
+    std::fclose(file);
+}
+
+namespace
+{
+    struct Message final
+    {
+        int sequence = 0;
+        std::string_view topic;
+        std::string_view payload;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Message::sequence, "sequence"),
+                MakeProperty(&Message::topic, "topic"),
+                MakeProperty(&Message::payload, "payload")
+            );
+        };
+    };
+}
+
+TEST(Allocations, DeserializeInsituDoesNotAllocateOnceWarm)
+{
+    JsonSerializer serializer{};
+    std::string const serialized{"{\"sequence\":9,\"topic\":\"a topic which does not fit in a small string\",\"payload\":\"escaped \\\"payload\\\"\"}"};
+    auto buffer = serialized;
+    serializer.DeserializeInsitu<Message>(buffer);
+    buffer = serialized;
+
+    AllocationCounter counter;
+    auto deserialized = serializer.DeserializeInsitu<Message>(buffer);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ("a topic which does not fit in a small string", deserialized.topic);
+    ASSERT_EQ("escaped \"payload\"", deserialized.payload);
+}
+
+TEST(Allocations, DeserializeIntoDoesNotAllocateOnceWarm)
+{
+    JsonSerializer serializer{};
+    auto serialized = serializer.Serialize(MakeOuter());
+    Outer target;
+    serializer.DeserializeInto(serialized, target);
+
+    AllocationCounter counter;
+    serializer.DeserializeInto(serialized, target);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ(serialized, serializer.Serialize(target));
+}
+
+TEST(Allocations, BinaryRoundTripDoesNotAllocateOnceWarm)
+{
+    Binary::BinarySerializer serializer;
+    auto value = MakeOuter();
+    std::string serialized;
+    Outer target;
+    serializer.Serialize(value, serialized);
+    serializer.DeserializeInto(serialized, target);
+
+    AllocationCounter counter;
+    serializer.Serialize(value, serialized);
+    serializer.DeserializeInto(serialized, target);
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ(value.inners[1].label, target.inners[1].label);
+}
+
+TEST(Allocations, FlatViewDoesNotAllocate)
+{
+    Flat::FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeOuter());
+
+    AllocationCounter counter;
+    Flat::FlatView<Outer> view(serialized);
+    auto label = view.Get<&Outer::inners>()[1].Get<&Inner::label>();
+    auto value = view.Get<&Outer::inners>()[0].Get<&Inner::values>()[2];
+
+    ASSERT_EQ(0u, counter.Count());
+    ASSERT_EQ("yet another label which does not fit in a small string", label);
+    ASSERT_EQ(3, value);
+}
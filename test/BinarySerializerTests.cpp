@@ -0,0 +1,486 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Binary;
+
+namespace
+{
+    enum class Color : uint8_t
+    {
+        Red,
+        Green
+    };
+
+    struct Sample final
+    {
+        int16_t small = 0;
+        uint32_t medium = 0;
+        double real = 0.0;
+        bool flag = false;
+        Color color = Color::Red;
+
+        bool operator==(Sample const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Sample::small, "small"),
+                MakeProperty(&Sample::medium, "medium"),
+                MakeProperty(&Sample::real, "real"),
+                MakeProperty(&Sample::flag, "flag"),
+                MakeProperty(&Sample::color, "color")
+            );
+        };
+    };
+
+    struct Container final
+    {
+        std::string name;
+        std::vector<Sample> samples;
+        std::vector<std::string> tags;
+        std::vector<bool> bits;
+        std::vector<std::vector<int>> nested;
+
+        bool operator==(Container const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Container::name, "name"),
+                MakeProperty(&Container::samples, "samples"),
+                MakeProperty(&Container::tags, "tags"),
+                MakeProperty(&Container::bits, "bits"),
+                MakeProperty(&Container::nested, "nested")
+            );
+        };
+    };
+
+    struct Constructed final
+    {
+        Constructed(std::string label, int count)
+            : label(std::move(label)),
+              count(count)
+        {
+        }
+
+        std::string label;
+        int count;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Constructed::label, "label"),
+                MakeProperty(&Constructed::count, "count")
+            );
+        };
+    };
+
+    struct WithConstructed final
+    {
+        Constructed const first;
+        std::vector<Constructed> rest;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WithConstructed::first, "first"),
+                MakeProperty(&WithConstructed::rest, "rest")
+            );
+        };
+    };
+
+    struct WithView final
+    {
+        std::string_view view;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(MakeProperty(&WithView::view, "view"));
+        };
+    };
+
+    Container MakeContainer()
+    {
+        return Container {
+            "container",
+            { Sample { -2, 70000, 1.5, true, Color::Green }, Sample {} },
+            { "a", "", std::string(200, 'x') },
+            { true, false, true },
+            { { 1, 2 }, {}, { 3 } }
+        };
+    }
+}
+
+TEST(BinarySerializer, WritesLittleEndianPropertiesInOrder)
+{
+    BinarySerializer serializer;
+    Sample value { 0x0102, 0x03040506, 1.0, true, Color::Green };
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(std::string("\x02\x01\x06\x05\x04\x03\x00\x00\x00\x00\x00\x00\xF0\x3F\x01\x01", 16), serialized);
+}
+
+TEST(BinarySerializer, PrefixesStringsAndVectorsWithLength)
+{
+    BinarySerializer serializer;
+
+    ASSERT_EQ(std::string("\x02hi", 3), serializer.Serialize(std::string("hi")));
+    ASSERT_EQ(std::string("\xC8\x01", 2) + std::string(200, 'x'), serializer.Serialize(std::string(200, 'x')));
+    ASSERT_EQ(std::string("\x02\x01\x00", 3), serializer.Serialize(std::vector<uint8_t>{ 1, 0 }));
+}
+
+TEST(BinarySerializer, RoundTripTest)
+{
+    BinarySerializer serializer;
+    auto value = MakeContainer();
+
+    auto deserialized = serializer.Deserialize<Container>(serializer.Serialize(value));
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(BinarySerializer, DeserializeIntoReusesStorage)
+{
+    BinarySerializer serializer;
+    auto value = MakeContainer();
+    Container target;
+    target.samples.resize(5);
+    target.tags.reserve(8);
+    auto tags = target.tags.data();
+
+    serializer.DeserializeInto(serializer.Serialize(value), target);
+
+    ASSERT_EQ(value, target);
+    ASSERT_EQ(tags, target.tags.data());
+}
+
+TEST(BinarySerializer, ConstructsTypesWithoutDefaultConstructor)
+{
+    BinarySerializer serializer;
+    WithConstructed value { Constructed("a", 1), { Constructed("b", 2), Constructed("c", 3) } };
+
+    auto deserialized = serializer.Deserialize<WithConstructed>(serializer.Serialize(value));
+
+    ASSERT_EQ("a", deserialized.first.label);
+    ASSERT_EQ(2u, deserialized.rest.size());
+    ASSERT_EQ(3, deserialized.rest[1].count);
+}
+
+TEST(BinarySerializer, StringViewsReferToBuffer)
+{
+    BinarySerializer serializer;
+    auto serialized = serializer.Serialize(WithView { "view" });
+
+    auto deserialized = serializer.Deserialize<WithView>(serialized);
+
+    ASSERT_EQ("view", deserialized.view);
+    ASSERT_EQ(serialized.data() + 1, deserialized.view.data());
+}
+
+TEST(BinarySerializer, ThrowsForTruncatedData)
+{
+    BinarySerializer serializer;
+    auto serialized = serializer.Serialize(MakeContainer());
+
+    for (std::size_t size = 0; size < serialized.size(); ++size)
+    {
+        ASSERT_THROW(serializer.Deserialize<Container>(std::string_view(serialized.data(), size)), OpCoSerializerException);
+    }
+}
+
+TEST(BinarySerializer, ThrowsForTrailingData)
+{
+    BinarySerializer serializer;
+    auto serialized = serializer.Serialize(MakeContainer()) + "x";
+
+    ASSERT_THROW(serializer.Deserialize<Container>(serialized), OpCoSerializerException);
+}
+
+TEST(BinarySerializer, ThrowsForOversizedLength)
+{
+    BinarySerializer serializer;
+
+    ASSERT_THROW(serializer.Deserialize<std::vector<double>>(std::string("\xFF\xFF\xFF\xFF\x0F", 5)), OpCoSerializerException);
+}
+
+namespace
+{
+    struct Point3 final
+    {
+        double x = 0.0;
+        double y = 0.0;
+        double z = 0.0;
+
+        bool operator==(Point3 const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Point3::x, "x"),
+                MakeProperty(&Point3::y, "y"),
+                MakeProperty(&Point3::z, "z")
+            );
+        };
+    };
+
+    struct Track final
+    {
+        Point3 start;
+        Point3 end;
+        int32_t id = 0;
+        Color color = Color::Red;
+        uint8_t flags[3] = {};
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Track::start, "start"),
+                MakeProperty(&Track::end, "end"),
+                MakeProperty(&Track::id, "id"),
+                MakeProperty(&Track::color, "color")
+            );
+        };
+    };
+
+    struct Reordered final
+    {
+        double x = 0.0;
+        double y = 0.0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Reordered::y, "y"),
+                MakeProperty(&Reordered::x, "x")
+            );
+        };
+    };
+
+    struct Packed final
+    {
+        int32_t a = 0;
+        int32_t b = 0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Packed::a, "a"),
+                MakeProperty(&Packed::b, "b")
+            );
+        };
+    };
+}
+
+namespace OpCoSerializer::Binary
+{
+    // Writes b before a, which a bulk copy would not respect.
+    template <>
+    struct BinaryTypeSerializer<Packed>
+    {
+        static void Write(BinaryWriter& writer, Packed const& value)
+        {
+            writer.Write(value.b);
+            writer.Write(value.a);
+        }
+
+        static void Read(BinaryReader& reader, Packed& value)
+        {
+            value.b = reader.Read<int32_t>();
+            value.a = reader.Read<int32_t>();
+        }
+    };
+}
+
+TEST(BinarySerializer, DetectsBulkCopyableTypes)
+{
+    ASSERT_TRUE(IsBulkCopyableV<double>);
+    ASSERT_TRUE(IsBulkCopyableV<Color>);
+    ASSERT_TRUE(IsBulkCopyableV<Point3>);
+    ASSERT_FALSE(IsBulkCopyableV<bool>);
+    ASSERT_FALSE(IsBulkCopyableV<Sample>);
+    ASSERT_FALSE(IsBulkCopyableV<Track>);
+    ASSERT_FALSE(IsBulkCopyableV<Reordered>);
+    ASSERT_FALSE(IsBulkCopyableV<Packed>);
+    ASSERT_FALSE(IsBulkCopyableV<std::string>);
+}
+
+TEST(BinarySerializer, BulkCopyMatchesPropertyEncoding)
+{
+    BinarySerializer serializer;
+    std::vector<Point3> points { Point3 { 1.0, 2.0, 3.0 }, Point3 { -4.5, 0.0, 1e300 } };
+    std::string expected;
+    BinaryWriter writer(expected);
+    writer.WriteSize(points.size());
+    for (auto const& point : points)
+    {
+        writer.Write(point.x);
+        writer.Write(point.y);
+        writer.Write(point.z);
+    }
+
+    auto serialized = serializer.Serialize(points);
+
+    ASSERT_EQ(expected, serialized);
+    ASSERT_EQ(points, serializer.Deserialize<std::vector<Point3>>(serialized));
+    ASSERT_EQ(points[1], serializer.Deserialize<Point3>(serializer.Serialize(points[1])));
+}
+
+TEST(BinarySerializer, SpecializationsAreNotBulkCopied)
+{
+    BinarySerializer serializer;
+    std::vector<Packed> values { Packed { 1, 2 } };
+
+    auto serialized = serializer.Serialize(values);
+    auto deserialized = serializer.Deserialize<std::vector<Packed>>(serialized);
+
+    ASSERT_EQ(std::string("\x01\x02\x00\x00\x00\x01\x00\x00\x00", 9), serialized);
+    ASSERT_EQ(1, deserialized[0].a);
+    ASSERT_EQ(2, deserialized[0].b);
+}
+
+TEST(BinarySerializer, ThrowsForOversizedBulkLength)
+{
+    BinarySerializer serializer;
+    auto serialized = serializer.Serialize(std::vector<double>{ 1.0, 2.0 });
+    serialized[0] = 3;
+
+    ASSERT_THROW(serializer.Deserialize<std::vector<double>>(serialized), OpCoSerializerException);
+}
+
+namespace
+{
+    struct Body final
+    {
+        double mass = 0.0;
+        Point3 position;
+        bool fixed = false;
+        std::string name;
+
+        bool operator==(Body const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Body::mass, "mass"),
+                MakeProperty(&Body::position, "position"),
+                MakeProperty(&Body::fixed, "fixed"),
+                MakeProperty(&Body::name, "name")
+            );
+        };
+    };
+}
+
+TEST(BinarySerializer, ColumnarWritesColumnPerProperty)
+{
+    BinarySerializer serializer;
+    Columnar<Body> bodies{ Body { 1.5, Point3 { 1, 2, 3 }, true, "a" }, Body { 2.5, Point3 { 4, 5, 6 }, false, "b" } };
+    std::string expected;
+    BinaryWriter writer(expected);
+    writer.WriteSize(bodies.size());
+    writer.Write(1.5);
+    writer.Write(2.5);
+    for (auto coordinate : { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 })
+    {
+        writer.Write(coordinate);
+    }
+
+    writer.Write(uint8_t{1});
+    writer.Write(uint8_t{0});
+    WriteBinary(writer, std::string("a"));
+    WriteBinary(writer, std::string("b"));
+
+    auto serialized = serializer.Serialize(bodies);
+
+    ASSERT_EQ(expected, serialized);
+    ASSERT_EQ(bodies, serializer.Deserialize<Columnar<Body>>(serialized));
+}
+
+TEST(BinarySerializer, ColumnarDeserializeIntoResizes)
+{
+    BinarySerializer serializer;
+    Columnar<Body> bodies{ Body { 1.5, Point3 {}, true, "a" } };
+    Columnar<Body> target{ Body {}, Body {}, Body {} };
+
+    serializer.DeserializeInto(serializer.Serialize(bodies), target);
+
+    ASSERT_EQ(bodies, target);
+}
+
+TEST(BinarySerializer, ColumnarThrowsForTruncatedColumn)
+{
+    BinarySerializer serializer;
+    auto serialized = serializer.Serialize(Columnar<Body>{ Body {}, Body {} });
+    serialized.resize(serialized.size() - 20);
+
+    ASSERT_THROW(serializer.Deserialize<Columnar<Body>>(serialized), OpCoSerializerException);
+}
+
+TEST(BinarySerializer, DeltaWritesOnlyChanges)
+{
+    BinarySerializer serializer;
+    auto previous = MakeContainer();
+    auto current = previous;
+    current.samples[1].real = 2.5;
+    current.bits[1] = true;
+    std::string expected;
+    BinaryWriter writer(expected);
+    writer.WriteSize(2);
+    writer.WriteSize(2);
+    writer.WriteSize(2);
+    writer.WriteSize(3);
+    writer.Write(2.5);
+    writer.WriteSize(0);
+    writer.WriteSize(0);
+    writer.WriteSize(4);
+    writer.WriteSize(3);
+    writer.WriteSize(2);
+    writer.Write(uint8_t{1});
+    writer.WriteSize(0);
+    writer.WriteSize(0);
+
+    auto delta = serializer.SerializeDelta(previous, current);
+
+    ASSERT_EQ(expected, delta);
+    ASSERT_EQ(std::string(1, '\0'), serializer.SerializeDelta(current, current));
+}
+
+TEST(BinarySerializer, ApplyDeltaPatchesInPlace)
+{
+    BinarySerializer serializer;
+    auto previous = MakeContainer();
+    auto current = previous;
+    current.name = "renamed";
+    current.samples.push_back(Sample { 1, 2, 3.0, false, Color::Green });
+    current.tags.pop_back();
+    current.bits = { false };
+    current.nested[0][1] = 9;
+    auto target = previous;
+    auto tag = target.tags[0].data();
+
+    serializer.ApplyDelta(serializer.SerializeDelta(previous, current), target);
+
+    ASSERT_EQ(current, target);
+    ASSERT_EQ(tag, target.tags[0].data());
+}
+
+TEST(BinarySerializer, ApplyDeltaThrowsForInvalidDelta)
+{
+    BinarySerializer serializer;
+    auto value = MakeContainer();
+
+    ASSERT_THROW(serializer.ApplyDelta(std::string("\x09", 1), value), OpCoSerializerException);
+    ASSERT_THROW(serializer.ApplyDelta(std::string("\x02\x05\x01\x00", 4), value), OpCoSerializerException);
+    ASSERT_THROW(serializer.ApplyDelta(std::string("\x02\x05\x00\x00", 4), value), OpCoSerializerException);
+}
@@ -0,0 +1,364 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <limits>
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Cbor;
+
+namespace
+{
+    enum class Color : int8_t
+    {
+        Blue = -1,
+        Red,
+        Green
+    };
+
+    struct Numbers final
+    {
+        int8_t int8 = 0;
+        int16_t int16 = 0;
+        int32_t int32 = 0;
+        int64_t int64 = 0;
+        uint8_t uint8 = 0;
+        uint16_t uint16 = 0;
+        uint32_t uint32 = 0;
+        uint64_t uint64 = 0;
+        float single = 0.0f;
+        double real = 0.0;
+        bool flag = false;
+        Color color = Color::Red;
+
+        bool operator==(Numbers const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Numbers::int8, "int8"),
+                MakeProperty(&Numbers::int16, "int16"),
+                MakeProperty(&Numbers::int32, "int32"),
+                MakeProperty(&Numbers::int64, "int64"),
+                MakeProperty(&Numbers::uint8, "uint8"),
+                MakeProperty(&Numbers::uint16, "uint16"),
+                MakeProperty(&Numbers::uint32, "uint32"),
+                MakeProperty(&Numbers::uint64, "uint64"),
+                MakeProperty(&Numbers::single, "single"),
+                MakeProperty(&Numbers::real, "real"),
+                MakeProperty(&Numbers::flag, "flag"),
+                MakeProperty(&Numbers::color, "color")
+            );
+        };
+    };
+
+    struct Document final
+    {
+        std::string name;
+        std::vector<Numbers> numbers;
+        std::vector<std::string> tags;
+        std::vector<bool> bits;
+        std::vector<std::vector<int>> nested;
+        std::vector<double> doubles;
+        std::vector<float> floats;
+        std::vector<int64_t> longs;
+        std::vector<uint8_t> bytes;
+
+        bool operator==(Document const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Document::name, "name"),
+                MakeProperty(&Document::numbers, "numbers"),
+                MakeProperty(&Document::tags, "tags"),
+                MakeProperty(&Document::bits, "bits"),
+                MakeProperty(&Document::nested, "nested"),
+                MakeProperty(&Document::doubles, "doubles"),
+                MakeProperty(&Document::floats, "floats"),
+                MakeProperty(&Document::longs, "longs"),
+                MakeProperty(&Document::bytes, "bytes")
+            );
+        };
+    };
+
+    struct Pair final
+    {
+        int first = 0;
+        std::string second;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Pair::first, "first"),
+                MakeProperty(&Pair::second, "second")
+            );
+        };
+    };
+
+    struct Constructed final
+    {
+        Constructed(std::string label, int count)
+            : label(std::move(label)),
+              count(count)
+        {
+        }
+
+        std::string label;
+        int count;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Constructed::label, "label"),
+                MakeProperty(&Constructed::count, "count")
+            );
+        };
+    };
+
+    struct WithConstructed final
+    {
+        Constructed const first;
+        std::vector<Constructed> rest;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WithConstructed::first, "first"),
+                MakeProperty(&WithConstructed::rest, "rest")
+            );
+        };
+    };
+
+    struct WithView final
+    {
+        std::string_view view;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(MakeProperty(&WithView::view, "view"));
+        };
+    };
+
+    Document MakeDocument()
+    {
+        using Int64Limits = std::numeric_limits<int64_t>;
+        return Document {
+            "document",
+            {
+                Numbers { -100, -30000, -2000000000, Int64Limits::min(), 200, 60000, 4000000000u, std::numeric_limits<uint64_t>::max(), 0.1f, 0.1, true, Color::Blue },
+                Numbers { 1, 1000, 100000, Int64Limits::max(), 0, 0, 0, 0, -1.5f, 1e300, false, Color::Green },
+                Numbers {}
+            },
+            { "a", "", std::string(40, 'x'), std::string(300, 'y'), std::string(70000, 'z') },
+            { true, false, true },
+            { { 1, -2 }, {}, std::vector<int>(20, 7) },
+            { 0.1, -2.5, 1e300 },
+            { 1.5f, -0.25f },
+            { std::numeric_limits<int64_t>::min(), 0, 42 },
+            { 0, 255 }
+        };
+    }
+}
+
+TEST(CborSerializer, WritesMapsKeyedByPropertyName)
+{
+    CborSerializer serializer;
+
+    auto serialized = serializer.Serialize(Pair { 1, "a" });
+
+    ASSERT_EQ(std::string("\xA2\x65" "first" "\x01\x66" "second" "\x61" "a"), serialized);
+}
+
+TEST(CborSerializer, WritesShortestIntegerArgument)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ(std::string("\x17"), serializer.Serialize(23));
+    ASSERT_EQ(std::string("\x18\x18"), serializer.Serialize(24));
+    ASSERT_EQ(std::string("\x19\x03\xE8"), serializer.Serialize(1000));
+    ASSERT_EQ(std::string("\x1A\x00\x0F\x42\x40", 5), serializer.Serialize(1000000));
+    ASSERT_EQ(std::string("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00", 9), serializer.Serialize(int64_t{1000000000000}));
+    ASSERT_EQ(std::string("\x20"), serializer.Serialize(-1));
+    ASSERT_EQ(std::string("\x38\x63"), serializer.Serialize(-100));
+    ASSERT_EQ(std::string("\x39\x03\xE7"), serializer.Serialize(-1000));
+    ASSERT_EQ(std::string("\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF"), serializer.Serialize(std::numeric_limits<int64_t>::min()));
+}
+
+TEST(CborSerializer, WritesSmallestExactFloat)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ(std::string("\xFA\x3F\xC0\x00\x00", 5), serializer.Serialize(1.5));
+    ASSERT_EQ(std::string("\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 9), serializer.Serialize(0.1));
+    ASSERT_EQ(std::string("\xF5"), serializer.Serialize(true));
+}
+
+TEST(CborSerializer, ReadsHalfPrecisionFloats)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ(1.0, serializer.Deserialize<double>(std::string("\xF9\x3C\x00", 3)));
+    ASSERT_EQ(65504.0f, serializer.Deserialize<float>(std::string("\xF9\x7B\xFF")));
+    ASSERT_EQ(-4.0, serializer.Deserialize<double>(std::string("\xF9\xC4\x00", 3)));
+    ASSERT_EQ(5.960464477539063e-8, serializer.Deserialize<double>(std::string("\xF9\x00\x01", 3)));
+}
+
+TEST(CborSerializer, WritesNumericVectorsAsTypedArrays)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ(std::string("\xD8\x56\x48\x00\x00\x00\x00\x00\x00\xF8\x3F", 11), serializer.Serialize(std::vector<double>{ 1.5 }));
+    ASSERT_EQ(std::string("\xD8\x55\x44\x00\x00\xC0\x3F", 7), serializer.Serialize(std::vector<float>{ 1.5f }));
+    ASSERT_EQ(std::string("\xD8\x40\x42\x01\x02", 5), serializer.Serialize(std::vector<uint8_t>{ 1, 2 }));
+    ASSERT_EQ(std::string("\xD8\x48\x41\xFE", 4), serializer.Serialize(std::vector<int8_t>{ -2 }));
+    ASSERT_EQ(std::string("\xD8\x45\x42\x01\x00", 5), serializer.Serialize(std::vector<uint16_t>{ 1 }));
+    ASSERT_EQ(std::string("\xD8\x4E\x44\xFF\xFF\xFF\xFF", 7), serializer.Serialize(std::vector<int32_t>{ -1 }));
+    ASSERT_EQ(std::string("\xD8\x47\x40", 3), serializer.Serialize(std::vector<uint64_t>{}));
+    ASSERT_EQ(std::string("\x82\xF5\xF4"), serializer.Serialize(std::vector<bool>{ true, false }));
+}
+
+TEST(CborSerializer, ReadsTypedArraysInEitherByteOrder)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ((std::vector<uint16_t>{ 1, 256 }), serializer.Deserialize<std::vector<uint16_t>>(std::string("\xD8\x41\x44\x00\x01\x01\x00", 7)));
+    ASSERT_EQ((std::vector<uint16_t>{ 1, 256 }), serializer.Deserialize<std::vector<uint16_t>>(std::string("\xD8\x45\x44\x01\x00\x00\x01", 7)));
+    ASSERT_EQ((std::vector<double>{ 1.5 }), serializer.Deserialize<std::vector<double>>(std::string("\xD8\x52\x48\x3F\xF8\x00\x00\x00\x00\x00\x00", 11)));
+}
+
+TEST(CborSerializer, ReadsNumericVectorsFromArrays)
+{
+    CborSerializer serializer;
+
+    ASSERT_EQ((std::vector<int>{ 1, -2, 3 }), serializer.Deserialize<std::vector<int>>(std::string("\x83\x01\x21\x03")));
+    ASSERT_EQ((std::vector<double>{ 1.0, 1.5 }), serializer.Deserialize<std::vector<double>>(std::string("\x82\x01\xFA\x3F\xC0\x00\x00", 7)));
+}
+
+TEST(CborSerializer, ThrowsForMismatchedTypedArrays)
+{
+    CborSerializer serializer;
+
+    ASSERT_THROW(serializer.Deserialize<std::vector<int32_t>>(serializer.Serialize(std::vector<float>{ 1.0f })), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<std::vector<uint32_t>>(serializer.Serialize(std::vector<int32_t>{ 1 })), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<std::vector<uint16_t>>(std::string("\xD8\x45\x43\x01\x00\x00", 6)), OpCoSerializerException);
+}
+
+TEST(CborSerializer, RoundTripTest)
+{
+    CborSerializer serializer;
+    auto value = MakeDocument();
+
+    auto deserialized = serializer.Deserialize<Document>(serializer.Serialize(value));
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(CborSerializer, DeserializeIntoReusesStorage)
+{
+    CborSerializer serializer;
+    auto value = MakeDocument();
+    Document target;
+    target.numbers.resize(5);
+    target.tags.reserve(8);
+    target.doubles.reserve(8);
+    auto tags = target.tags.data();
+    auto doubles = target.doubles.data();
+
+    serializer.DeserializeInto(serializer.Serialize(value), target);
+
+    ASSERT_EQ(value, target);
+    ASSERT_EQ(tags, target.tags.data());
+    ASSERT_EQ(doubles, target.doubles.data());
+}
+
+TEST(CborSerializer, ReadsKeysInAnyOrderAndSkipsUnknownKeys)
+{
+    CborSerializer serializer;
+    // {"unknown": [1, {"a": null}, 1(2.5), h'00'], "second": "b", "first": 300}
+    std::string serialized("\xA3\x67unknown\x84\x01\xA1\x61" "a\xF6\xC1\xFB\x40\x04\x00\x00\x00\x00\x00\x00\x41\x00\x66second\x61" "b\x65" "first\x19\x01\x2C", 45);
+
+    auto deserialized = serializer.Deserialize<Pair>(serialized);
+
+    ASSERT_EQ(300, deserialized.first);
+    ASSERT_EQ("b", deserialized.second);
+}
+
+TEST(CborSerializer, MissingPropertiesAreOptionalUnlessRequired)
+{
+    std::string serialized("\xA1\x65" "first\x05");
+
+    ASSERT_EQ(5, CborSerializer().Deserialize<Pair>(serialized).first);
+    ASSERT_THROW(
+        CborSerializer(CborSerializerSettings{ .propertiesRequired = true }).Deserialize<Pair>(serialized),
+        OpCoSerializerException);
+}
+
+TEST(CborSerializer, ConstructsTypesWithoutDefaultConstructor)
+{
+    CborSerializer serializer;
+    WithConstructed value { Constructed("a", 1), { Constructed("b", 2), Constructed("c", 3) } };
+
+    auto deserialized = serializer.Deserialize<WithConstructed>(serializer.Serialize(value));
+
+    ASSERT_EQ("a", deserialized.first.label);
+    ASSERT_EQ(2u, deserialized.rest.size());
+    ASSERT_EQ(3, deserialized.rest[1].count);
+}
+
+TEST(CborSerializer, StringViewsReferToBuffer)
+{
+    CborSerializer serializer;
+    auto serialized = serializer.Serialize(WithView { "view" });
+
+    auto deserialized = serializer.Deserialize<WithView>(serialized);
+
+    ASSERT_EQ("view", deserialized.view);
+    ASSERT_EQ(serialized.data() + 7, deserialized.view.data());
+}
+
+TEST(CborSerializer, ThrowsForOutOfRangeOrMismatchedValues)
+{
+    CborSerializer serializer;
+
+    ASSERT_THROW(serializer.Deserialize<uint8_t>(serializer.Serialize(256)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<uint32_t>(serializer.Serialize(-1)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<int64_t>(std::string("\x3B\x80\x00\x00\x00\x00\x00\x00\x00", 9)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<int>(serializer.Serialize(1.5)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<std::string>(serializer.Serialize(1)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<std::vector<int>>(std::string("\x9F\x01\xFF")), OpCoSerializerException);
+    ASSERT_EQ(3.0, serializer.Deserialize<double>(serializer.Serialize(3)));
+}
+
+TEST(CborSerializer, ThrowsForTruncatedData)
+{
+    CborSerializer serializer;
+    auto value = MakeDocument();
+    value.tags.pop_back();
+    auto serialized = serializer.Serialize(value);
+
+    for (std::size_t size = 0; size < serialized.size(); ++size)
+    {
+        ASSERT_THROW(serializer.Deserialize<Document>(std::string_view(serialized.data(), size)), OpCoSerializerException);
+    }
+}
+
+TEST(CborSerializer, ThrowsForTrailingData)
+{
+    CborSerializer serializer;
+    auto serialized = serializer.Serialize(MakeDocument()) + "x";
+
+    ASSERT_THROW(serializer.Deserialize<Document>(serialized), OpCoSerializerException);
+}
@@ -63,3 +63,68 @@ TEST(HasSerializablePropertiesV, WhenDoesNotHaveSerializablePropertiesIsFalse)
 {
     ASSERT_FALSE(HasSerializablePropertiesV<WithoutProperties>);
 }
+
+struct Wide final
+{
+    int alpha, bravo, charlie, delta, echo, foxtrot, golf, hotel, india, juliett, kilo, lima;
+    int mike, november, oscar, papa, quebec, romeo, sierra, tango, ab, ba, a, b;
+
+    static auto constexpr SerializerProperties()
+    {
+        return std::make_tuple(
+            OPCOSERIALIZER_PROPERTY(Wide, alpha), OPCOSERIALIZER_PROPERTY(Wide, bravo),
+            OPCOSERIALIZER_PROPERTY(Wide, charlie), OPCOSERIALIZER_PROPERTY(Wide, delta),
+            OPCOSERIALIZER_PROPERTY(Wide, echo), OPCOSERIALIZER_PROPERTY(Wide, foxtrot),
+            OPCOSERIALIZER_PROPERTY(Wide, golf), OPCOSERIALIZER_PROPERTY(Wide, hotel),
+            OPCOSERIALIZER_PROPERTY(Wide, india), OPCOSERIALIZER_PROPERTY(Wide, juliett),
+            OPCOSERIALIZER_PROPERTY(Wide, kilo), OPCOSERIALIZER_PROPERTY(Wide, lima),
+            OPCOSERIALIZER_PROPERTY(Wide, mike), OPCOSERIALIZER_PROPERTY(Wide, november),
+            OPCOSERIALIZER_PROPERTY(Wide, oscar), OPCOSERIALIZER_PROPERTY(Wide, papa),
+            OPCOSERIALIZER_PROPERTY(Wide, quebec), OPCOSERIALIZER_PROPERTY(Wide, romeo),
+            OPCOSERIALIZER_PROPERTY(Wide, sierra), OPCOSERIALIZER_PROPERTY(Wide, tango),
+            OPCOSERIALIZER_PROPERTY(Wide, ab), OPCOSERIALIZER_PROPERTY(Wide, ba),
+            OPCOSERIALIZER_PROPERTY(Wide, a), OPCOSERIALIZER_PROPERTY(Wide, b)
+        );
+    };
+};
+
+TEST(PropertyLookup, FindsEveryPropertyIndex)
+{
+    std::size_t index = 0;
+    ForProperty<Wide>([&](auto& property) {
+        auto name = std::string(property.name);
+        ASSERT_EQ(index, PropertyLookup<Wide>::Find(name.c_str(), name.size()));
+        ++index;
+    });
+}
+
+TEST(PropertyLookup, DoesNotFindUnknownNames)
+{
+    ASSERT_EQ(PropertyLookup<Wide>::npos, PropertyLookup<Wide>::Find("zulu", 4));
+    ASSERT_EQ(PropertyLookup<Wide>::npos, PropertyLookup<Wide>::Find("alph", 4));
+    ASSERT_EQ(PropertyLookup<Wide>::npos, PropertyLookup<Wide>::Find("alphabet", 8));
+    ASSERT_EQ(PropertyLookup<Wide>::npos, PropertyLookup<Wide>::Find("", 0));
+    ASSERT_EQ(PropertyLookup<WithProperties>::npos, PropertyLookup<WithProperties>::Find("i", 1));
+}
+
+TEST(PropertyLookup, FindsNamesWithoutNullTerminator)
+{
+    auto constexpr buffer = "alphabet";
+
+    ASSERT_EQ(0u, PropertyLookup<Wide>::Find(buffer, 5));
+    ASSERT_EQ(22u, PropertyLookup<Wide>::Find(buffer, 1));
+}
+
+TEST(PropertyLookup, IsUsableAtCompileTime)
+{
+    static_assert(PropertyLookup<WithProperties>::Find("integer", 7) == 0);
+}
+
+TEST(ForPropertyAt, AppliesFunctionToPropertyAtIndex)
+{
+    std::string name;
+
+    ForPropertyAt<Wide>(13, [&](auto& property) { name = property.name; });
+
+    ASSERT_EQ("november", name);
+}
@@ -0,0 +1,249 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Flat;
+
+namespace
+{
+    enum class Terrain : uint8_t
+    {
+        Land,
+        Water
+    };
+
+    struct Position final
+    {
+        double latitude = 0.0;
+        double longitude = 0.0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Position::latitude, "latitude"),
+                MakeProperty(&Position::longitude, "longitude")
+            );
+        };
+    };
+
+    struct Site final
+    {
+        std::string name;
+        Position position;
+        Terrain terrain = Terrain::Land;
+        bool active = false;
+        std::vector<std::string> tags;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Site::name, "name"),
+                MakeProperty(&Site::position, "position"),
+                MakeProperty(&Site::terrain, "terrain"),
+                MakeProperty(&Site::active, "active"),
+                MakeProperty(&Site::tags, "tags")
+            );
+        };
+    };
+
+    struct Scenario final
+    {
+        int16_t version = 0;
+        double duration = 0.0;
+        std::string title;
+        std::vector<double> elevations;
+        std::vector<bool> flags;
+        std::vector<Site> sites;
+        std::vector<std::vector<int>> nested;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Scenario::version, "version"),
+                MakeProperty(&Scenario::duration, "duration"),
+                MakeProperty(&Scenario::title, "title"),
+                MakeProperty(&Scenario::elevations, "elevations"),
+                MakeProperty(&Scenario::flags, "flags"),
+                MakeProperty(&Scenario::sites, "sites"),
+                MakeProperty(&Scenario::nested, "nested")
+            );
+        };
+    };
+
+    // The first two properties of Scenario, as an older version of it.
+    struct ScenarioVersion1 final
+    {
+        int16_t version = 0;
+        double duration = 0.0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&ScenarioVersion1::version, "version"),
+                MakeProperty(&ScenarioVersion1::duration, "duration")
+            );
+        };
+    };
+
+    Scenario MakeScenario()
+    {
+        return Scenario {
+            -3,
+            3600.5,
+            "scenario",
+            { 1.5, -2.25, 100.0 },
+            { true, false, true },
+            {
+                Site { "harbour", Position { 50.5, -1.25 }, Terrain::Water, true, { "port", "" } },
+                Site { "airfield", Position { 51.0, 0.5 }, Terrain::Land, false, {} }
+            },
+            { { 1, 2 }, {} }
+        };
+    }
+}
+
+namespace
+{
+    // Reads every value in the view, so every byte of the buffer is needed.
+    void ReadAll(FlatView<Scenario> const& view)
+    {
+        static_cast<void>(view.Get<&Scenario::version>());
+        static_cast<void>(view.Get<&Scenario::duration>());
+        static_cast<void>(view.Get<&Scenario::title>());
+        for (auto elevation : view.Get<&Scenario::elevations>())
+        {
+            static_cast<void>(elevation);
+        }
+
+        for (auto flag : view.Get<&Scenario::flags>())
+        {
+            static_cast<void>(flag);
+        }
+
+        for (auto site : view.Get<&Scenario::sites>())
+        {
+            static_cast<void>(site.Get<&Site::name>());
+            static_cast<void>(site.Get<&Site::position>().Get<&Position::longitude>());
+            static_cast<void>(site.Get<&Site::terrain>());
+            static_cast<void>(site.Get<&Site::active>());
+            for (auto tag : site.Get<&Site::tags>())
+            {
+                static_cast<void>(tag);
+            }
+        }
+
+        for (auto values : view.Get<&Scenario::nested>())
+        {
+            for (auto value : values)
+            {
+                static_cast<void>(value);
+            }
+        }
+    }
+}
+
+TEST(FlatSerializer, ViewReadsScalarsAndStrings)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeScenario());
+
+    FlatView<Scenario> view(serialized);
+
+    ASSERT_EQ(-3, view.Get<&Scenario::version>());
+    ASSERT_EQ(3600.5, view.Get<&Scenario::duration>());
+    ASSERT_EQ("scenario", view.Get<&Scenario::title>());
+}
+
+TEST(FlatSerializer, ViewReadsVectorsAndNestedValues)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeScenario());
+
+    FlatView<Scenario> view(serialized);
+    auto elevations = view.Get<&Scenario::elevations>();
+    auto sites = view.Get<&Scenario::sites>();
+    auto harbour = sites[0];
+
+    ASSERT_EQ(3u, elevations.Size());
+    ASSERT_EQ(-2.25, elevations[1]);
+    ASSERT_EQ((std::vector<double>(elevations.begin(), elevations.end())), MakeScenario().elevations);
+    ASSERT_EQ((std::vector<bool>{ true, false, true }), (std::vector<bool>(view.Get<&Scenario::flags>().begin(), view.Get<&Scenario::flags>().end())));
+    ASSERT_EQ(2u, sites.Size());
+    ASSERT_EQ("harbour", harbour.Get<&Site::name>());
+    ASSERT_EQ(-1.25, harbour.Get<&Site::position>().Get<&Position::longitude>());
+    ASSERT_EQ(Terrain::Water, harbour.Get<&Site::terrain>());
+    ASSERT_TRUE(harbour.Get<&Site::active>());
+    ASSERT_EQ("", harbour.Get<&Site::tags>()[1]);
+    ASSERT_TRUE(sites[1].Get<&Site::tags>().Empty());
+    ASSERT_EQ(2, view.Get<&Scenario::nested>()[0][1]);
+}
+
+TEST(FlatSerializer, ViewsValuesInPlace)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeScenario());
+
+    FlatView<Scenario> view(serialized);
+    auto title = view.Get<&Scenario::title>();
+
+    ASSERT_GE(title.data(), serialized.data());
+    ASSERT_LT(title.data(), serialized.data() + serialized.size());
+    ASSERT_EQ('\0', title.data()[title.size()]);
+}
+
+TEST(FlatSerializer, AlignsNumbers)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeScenario());
+
+    // The duration is the second field of the root table.
+    auto root = LoadFlat<FlatOffset>(serialized, 0);
+    auto duration = LoadFlat<FlatOffset>(serialized, root + 2 * sizeof(FlatOffset));
+
+    ASSERT_EQ(0u, root % FlatAlignment);
+    ASSERT_EQ(0u, duration % alignof(double));
+}
+
+TEST(FlatSerializer, MissingFieldsHaveDefaultValues)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(ScenarioVersion1 { 2, 10.0 });
+
+    FlatView<Scenario> view(serialized);
+
+    ASSERT_EQ(2, view.Get<&Scenario::version>());
+    ASSERT_EQ("", view.Get<&Scenario::title>());
+    ASSERT_TRUE(view.Get<&Scenario::sites>().Empty());
+}
+
+TEST(FlatSerializer, ThrowsForOutOfRangeReads)
+{
+    FlatSerializer serializer;
+    auto serialized = serializer.Serialize(MakeScenario());
+
+    FlatView<Scenario> view(serialized);
+
+    ASSERT_THROW(view.Get<&Scenario::elevations>()[3], OpCoSerializerException);
+    ASSERT_THROW(FlatView<Scenario>(std::string_view(serialized.data(), 3)), OpCoSerializerException);
+
+    for (std::size_t size = 0; size < serialized.size(); ++size)
+    {
+        ASSERT_THROW(ReadAll(FlatView<Scenario>(std::string_view(serialized.data(), size))), OpCoSerializerException) << size;
+    }
+}
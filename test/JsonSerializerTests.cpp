@@ -18,6 +18,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
 #include <gtest/gtest.h>
 #include "OpCoSerializer/OpCoSerializer.hpp"
 
@@ -170,3 +177,930 @@ TEST(JsonSerializer, EnumRoundTripTest)
 
     ASSERT_EQ(value, deserialized);
 }
+
+struct WithNestedVector final
+{
+    std::vector<Nested> nested;
+    std::vector<std::string> strings;
+    std::vector<int> empty;
+    TestEnum enumValue = TestEnum::Value;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&WithNestedVector::nested, "nested"),
+            MakeProperty(&WithNestedVector::strings, "strings"),
+            MakeProperty(&WithNestedVector::empty, "empty"),
+            MakeProperty(&WithNestedVector::enumValue, "enum")
+        );
+    };
+};
+
+template <typename TWriter, typename T>
+std::string SerializeThroughDocument(T value)
+{
+    rapidjson::Document document;
+    auto json = JsonTypeSerializer<T>::Serialize(document, value);
+    rapidjson::StringBuffer buffer;
+    TWriter writer(buffer);
+    json.Accept(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+TEST(JsonSerializer, StreamingSerializeMatchesDocument)
+{
+    JsonSerializer serializer{};
+    WithNestedVector value = {
+        { Nested { 1 }, Nested { -2 } },
+        { "a", "b\"c" },
+        {},
+        TestEnum::Value
+    };
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(SerializeThroughDocument<rapidjson::Writer<rapidjson::StringBuffer>>(value), serialized);
+}
+
+TEST(JsonSerializer, StreamingPrettySerializeMatchesDocument)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .pretty = true }};
+    WithNestedVector value = {
+        { Nested { 1 }, Nested { -2 } },
+        { "a", "b\"c" },
+        {},
+        TestEnum::Value
+    };
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(SerializeThroughDocument<rapidjson::PrettyWriter<rapidjson::StringBuffer>>(value), serialized);
+}
+
+template <typename TWriter>
+std::string WriteKeys(bool raw)
+{
+    rapidjson::StringBuffer buffer;
+    TWriter writer(buffer);
+    writer.StartObject();
+    std::size_t index = 0;
+    ForProperty<TestTypeWithProperties>([&](auto& property) {
+        if (raw)
+        {
+            JsonKeys<TestTypeWithProperties>::Write(writer, index);
+        }
+        else
+        {
+            writer.Key(property.name, static_cast<rapidjson::SizeType>(property.nameLength));
+        }
+
+        writer.Int(static_cast<int>(index++));
+    });
+
+    writer.EndObject();
+    return buffer.GetString();
+}
+
+TEST(JsonSerializer, KeysMatchWriterKeys)
+{
+    ASSERT_EQ(WriteKeys<rapidjson::Writer<rapidjson::StringBuffer>>(false), WriteKeys<rapidjson::Writer<rapidjson::StringBuffer>>(true));
+    ASSERT_EQ(WriteKeys<rapidjson::PrettyWriter<rapidjson::StringBuffer>>(false), WriteKeys<rapidjson::PrettyWriter<rapidjson::StringBuffer>>(true));
+}
+
+struct Celsius final
+{
+    double degrees = 0.0;
+};
+
+namespace OpCoSerializer::Json
+{
+    // A custom specialization with only the document based interface.
+    template <>
+    struct JsonTypeSerializer<Celsius>
+    {
+        static rapidjson::Value Serialize(rapidjson::Document& document, Celsius const& value)
+        {
+            rapidjson::Value array;
+            array.SetArray();
+            array.PushBack(rapidjson::Value(value.degrees), document.GetAllocator());
+            array.PushBack(rapidjson::Value("C"), document.GetAllocator());
+            return array;
+        }
+
+        static Celsius Deserialize(rapidjson::Value& value)
+        {
+            return Celsius { value.GetArray()[0].GetDouble() };
+        }
+    };
+}
+
+struct WithCustom final
+{
+    Celsius temperature;
+    int after = 0;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&WithCustom::temperature, "temperature"),
+            MakeProperty(&WithCustom::after, "after")
+        );
+    };
+};
+
+TEST(JsonSerializer, DeserializesNestedVectors)
+{
+    JsonSerializer serializer{};
+    std::string string{"{\"nested\":[{\"value\":1},{\"value\":-2}],\"strings\":[\"a\",\"b\\\"c\"],\"empty\":[],\"enum\":0}"};
+
+    auto deserialized = serializer.Deserialize<WithNestedVector>(string);
+
+    ASSERT_EQ((std::vector<Nested>{ Nested { 1 }, Nested { -2 } }), deserialized.nested);
+    ASSERT_EQ((std::vector<std::string>{ "a", "b\"c" }), deserialized.strings);
+    ASSERT_TRUE(deserialized.empty.empty());
+}
+
+TEST(JsonSerializer, DeserializeSkipsUnknownProperties)
+{
+    JsonSerializer serializer{};
+    std::string string{"{\"unknown\":{\"a\":[1,{\"b\":2}]},\"nested\":{\"value\":3},\"other\":[[]]}"};
+
+    auto deserialized = serializer.Deserialize<WithNested>(string);
+
+    ASSERT_EQ(3, deserialized.nested.value);
+}
+
+TEST(JsonSerializer, DeserializeUsesDefaultsForMissingProperties)
+{
+    JsonSerializer serializer{};
+
+    auto deserialized = serializer.Deserialize<TestTypeWithProperties>("{\"integer\":9}");
+
+    ASSERT_EQ(9, deserialized.i);
+    ASSERT_EQ(1.23, deserialized.d);
+    ASSERT_EQ((std::vector<double>{1.2, 3.4}), deserialized.v);
+}
+
+TEST(JsonSerializer, DeserializeThrowsForMissingRequiredProperty)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .propertiesRequired = true }};
+
+    ASSERT_THROW(serializer.Deserialize<TestTypeWithProperties>("{\"integer\":9}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, DeserializeThrowsForMissingNestedProperty)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<WithNested>("{\"nested\":{}}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, DeserializeThrowsForInvalidJson)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<WithNested>("{\"nested\":"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, DeserializeThrowsForMismatchedType)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<TestTypeWithProperties>("{\"integer\":\"nine\"}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<TestTypeWithProperties>("{\"integer\":1.5}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, CustomTypeSerializerRoundTripTest)
+{
+    JsonSerializer serializer{};
+    WithCustom value = { Celsius { 21.5 }, 7 };
+
+    auto serialized = serializer.Serialize(value);
+    auto deserialized = serializer.Deserialize<WithCustom>(serialized);
+
+    ASSERT_EQ("{\"temperature\":[21.5,\"C\"],\"after\":7}", serialized);
+    ASSERT_EQ(21.5, deserialized.temperature.degrees);
+    ASSERT_EQ(7, deserialized.after);
+}
+
+TEST(JsonSerializer, IsReusableAfterFailure)
+{
+    JsonSerializer serializer{};
+    WithNested value = { Nested { 4 } };
+
+    ASSERT_THROW(serializer.Deserialize<WithNested>("{\"nested\":{\"value\":[}}"), OpCoSerializerException);
+    auto serialized = serializer.Serialize(value);
+    auto deserialized = serializer.Deserialize<WithNested>(serialized);
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(JsonSerializer, CopiesSettings)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .pretty = true }};
+    JsonSerializer copy = serializer;
+    WithNested value = { Nested { 4 } };
+
+    ASSERT_EQ(serializer.Serialize(value), copy.Serialize(value));
+}
+
+TEST(JsonSerializer, PolicyMatchesSettings)
+{
+    BasicJsonSerializer<JsonSerializerPolicy<true>> policySerializer{};
+    JsonSerializer serializer{JsonSerializerSettings{ .pretty = true }};
+    WithNestedVector value = { { Nested { 1 } }, { "a" }, {}, TestEnum::Value };
+
+    auto serialized = policySerializer.Serialize(value);
+
+    ASSERT_EQ(serializer.Serialize(value), serialized);
+    ASSERT_EQ(serialized, policySerializer.Serialize(policySerializer.Deserialize<WithNestedVector>(serialized)));
+}
+
+TEST(JsonSerializer, PolicyPropertiesRequiredThrowsForMissingProperty)
+{
+    BasicJsonSerializer<JsonSerializerPolicy<false, true>> serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<Nested>("{}"), OpCoSerializerException);
+    ASSERT_EQ(Nested { 3 }, serializer.Deserialize<Nested>("{\"value\":3}"));
+}
+
+TEST(JsonSerializer, FileRoundTripTest)
+{
+    JsonSerializer serializer{};
+    TestTypeWithProperties value = { 9, 2.5, false, { 1.5, 2.5 }, "file" };
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::tmpfile(), &std::fclose);
+
+    serializer.Serialize(value, file.get());
+    std::rewind(file.get());
+    auto deserialized = serializer.Deserialize<TestTypeWithProperties>(file.get());
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(JsonSerializer, StreamMatchesString)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .pretty = true }};
+    WithNested value = { Nested { 4 } };
+    std::ostringstream output;
+
+    serializer.Serialize(value, output);
+
+    ASSERT_EQ(serializer.Serialize(value), output.str());
+}
+
+TEST(JsonSerializer, StreamRoundTripTestLargerThanBuffer)
+{
+    JsonSerializer serializer{};
+    TestTypeWithProperties value;
+    value.v.resize(100000);
+    for (std::size_t i = 0; i < value.v.size(); ++i)
+    {
+        value.v[i] = static_cast<double>(i) + 0.25;
+    }
+
+    std::stringstream stream;
+    serializer.Serialize(value, stream);
+    auto deserialized = serializer.Deserialize<TestTypeWithProperties>(stream);
+
+    ASSERT_GT(stream.str().size(), JsonStreamBufferSize);
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(JsonSerializer, PathRoundTripTest)
+{
+    JsonSerializer serializer{};
+    WithNestedVector value = { { Nested { 1 }, Nested { 2 } }, { "a", "b" }, {}, TestEnum::Value };
+    auto path = std::filesystem::temp_directory_path() / "OpCoSerializerPathRoundTripTest.json";
+
+    serializer.SerializeToFile(value, path);
+    auto deserialized = serializer.DeserializeFromFile<WithNestedVector>(path);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(value.nested, deserialized.nested);
+    ASSERT_EQ(value.strings, deserialized.strings);
+}
+
+TEST(JsonSerializer, DeserializeFromMissingFileThrows)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.DeserializeFromFile<WithNested>("does/not/exist.json"), OpCoSerializerException);
+}
+
+struct WithViews final
+{
+    int id = 0;
+    std::string_view name;
+    std::vector<std::string_view> tags;
+    std::string copied;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&WithViews::id, "id"),
+            MakeProperty(&WithViews::name, "name"),
+            MakeProperty(&WithViews::tags, "tags"),
+            MakeProperty(&WithViews::copied, "copied")
+        );
+    };
+};
+
+TEST(JsonSerializer, DeserializeInsituPointsIntoBuffer)
+{
+    JsonSerializer serializer{};
+    std::string buffer = "{\"id\":3,\"name\":\"a \\\"quoted\\\"\\nname\",\"tags\":[\"x\",\"\\u00e9\"],\"copied\":\"c\"}";
+    auto deserialized = serializer.DeserializeInsitu<WithViews>(buffer);
+
+    ASSERT_EQ(3, deserialized.id);
+    ASSERT_EQ("a \"quoted\"\nname", deserialized.name);
+    ASSERT_EQ((std::vector<std::string_view>{ "x", "\xc3\xa9" }), deserialized.tags);
+    ASSERT_EQ("c", deserialized.copied);
+    ASSERT_GE(deserialized.name.data(), buffer.data());
+    ASSERT_LT(deserialized.name.data(), buffer.data() + buffer.size());
+}
+
+TEST(JsonSerializer, DeserializeInsituStopsAtEndOfBuffer)
+{
+    JsonSerializer serializer{};
+    std::string buffer = "{\"id\":3,\"name\":\"n\"}trailing";
+    auto deserialized = serializer.DeserializeInsitu<WithViews>(std::span<char>(buffer.data(), buffer.size() - 8));
+
+    ASSERT_EQ("n", deserialized.name);
+}
+
+TEST(JsonSerializer, StringViewRequiresInsitu)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<WithViews>("{\"name\":\"n\"}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, SerializesStringViews)
+{
+    JsonSerializer serializer{};
+    WithViews value = { 1, "name", { "a" }, "" };
+
+    ASSERT_EQ("{\"id\":1,\"name\":\"name\",\"tags\":[\"a\"],\"copied\":\"\"}", serializer.Serialize(value));
+    ASSERT_EQ(serializer.Serialize(value), SerializeThroughDocument<rapidjson::Writer<rapidjson::StringBuffer>>(value));
+}
+
+TEST(JsonSerializer, DeserializesSliceWithoutNullTerminator)
+{
+    JsonSerializer serializer{};
+    std::string packet = "header{\"nested\":{\"value\":12}}{\"nested\":{\"value\":3}}";
+    std::string_view slice(packet.data() + 6, 23);
+
+    ASSERT_EQ(12, serializer.Deserialize<WithNested>(slice).nested.value);
+    ASSERT_EQ(3, serializer.Deserialize<WithNested>(packet.data() + 29, 22).nested.value);
+}
+
+TEST(JsonSerializer, DeserializeKeepsEmbeddedNullCharacters)
+{
+    JsonSerializer serializer{};
+    auto expected = std::string("a\0b", 3);
+
+    auto deserialized = serializer.Deserialize<TestTypeWithProperties>("{\"string\":\"a\\u0000b\"}");
+    rapidjson::Document document;
+    document.Parse("\"a\\u0000b\"");
+
+    ASSERT_EQ(expected, deserialized.s);
+    ASSERT_EQ(expected, JsonTypeSerializer<std::string>::Deserialize(document));
+}
+
+TEST(JsonSerializer, DeserializeIntoOverwritesInPlace)
+{
+    JsonSerializer serializer{};
+    WithNestedVector value = { { Nested { 1 }, Nested { 2 }, Nested { 3 } }, { "a", "b" }, { 9 }, TestEnum::Value };
+
+    serializer.DeserializeInto("{\"nested\":[{\"value\":4},{\"value\":5}],\"strings\":[\"c\",\"d\",\"e\"]}", value);
+
+    ASSERT_EQ((std::vector<Nested>{ Nested { 4 }, Nested { 5 } }), value.nested);
+    ASSERT_EQ((std::vector<std::string>{ "c", "d", "e" }), value.strings);
+    ASSERT_EQ(std::vector<int>{ 9 }, value.empty);
+}
+
+TEST(JsonSerializer, DeserializeIntoReusesVectorElements)
+{
+    JsonSerializer serializer{};
+    TestTypeWithProperties value;
+    value.v.reserve(16);
+    auto data = value.v.data();
+
+    serializer.DeserializeInto("{\"vector\":[1,2,3,4]}", value);
+
+    ASSERT_EQ((std::vector<double>{ 1, 2, 3, 4 }), value.v);
+    ASSERT_EQ(data, value.v.data());
+}
+
+struct Vector2 final
+{
+    double x;
+    double y;
+
+    static auto constexpr SerializerProperties() {
+        return std::make_tuple(MakeProperty(&Vector2::x, "x"), MakeProperty(&Vector2::y, "y"));
+    };
+};
+
+struct Reading final
+{
+    Reading(std::string sensor, double value)
+        : sensor(std::move(sensor)),
+          value(value)
+    {
+    }
+
+    std::string sensor;
+    double value;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Reading::sensor, "sensor"),
+            MakeProperty(&Reading::value, "value")
+        );
+    };
+};
+
+struct CopyCounter final
+{
+    static inline int copies = 0;
+
+    std::vector<int> values;
+
+    CopyCounter() = default;
+    CopyCounter(CopyCounter const& other) : values(other.values) { ++copies; }
+    CopyCounter(CopyCounter&&) = default;
+    CopyCounter& operator=(CopyCounter const& other) { values = other.values; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter&&) = default;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(MakeProperty(&CopyCounter::values, "values"));
+    };
+};
+
+struct Snapshot final
+{
+    int const id;
+    Reading latest;
+    std::vector<Reading> history;
+    CopyCounter counter;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Snapshot::id, "id"),
+            MakeProperty(&Snapshot::latest, "latest"),
+            MakeProperty(&Snapshot::history, "history"),
+            MakeProperty(&Snapshot::counter, "counter")
+        );
+    };
+};
+
+TEST(JsonSerializer, ConstructsTypesWithoutDefaultConstructor)
+{
+    JsonSerializer serializer{};
+    Snapshot value{ 7, Reading("a", 1.5), { Reading("b", 2.5), Reading("c", 3.5) }, CopyCounter() };
+    value.counter.values = { 1, 2 };
+    auto serialized = serializer.Serialize(value);
+    CopyCounter::copies = 0;
+
+    auto deserialized = serializer.Deserialize<Snapshot>(serialized);
+
+    ASSERT_EQ(0, CopyCounter::copies);
+    ASSERT_EQ(7, deserialized.id);
+    ASSERT_EQ("a", deserialized.latest.sensor);
+    ASSERT_EQ(2u, deserialized.history.size());
+    ASSERT_EQ(3.5, deserialized.history[1].value);
+    ASSERT_EQ((std::vector<int>{ 1, 2 }), deserialized.counter.values);
+    ASSERT_EQ(serialized, serializer.Serialize(deserialized));
+}
+
+TEST(JsonSerializer, ConstructsTypesWithoutDefaultConstructorThroughDocument)
+{
+    rapidjson::Document document;
+    document.Parse("{\"id\":2,\"latest\":{\"sensor\":\"s\",\"value\":4},\"history\":[{\"sensor\":\"t\",\"value\":5}],\"counter\":{\"values\":[]}}");
+
+    auto deserialized = JsonTypeSerializer<Snapshot>::Deserialize(document);
+
+    ASSERT_EQ(2, deserialized.id);
+    ASSERT_EQ("s", deserialized.latest.sensor);
+    ASSERT_EQ("t", deserialized.history[0].sensor);
+}
+
+TEST(JsonSerializer, ConstructedTypesValueInitializeMissingProperties)
+{
+    JsonSerializer serializer{};
+
+    auto deserialized = serializer.Deserialize<Reading>("{\"sensor\":\"s\"}");
+
+    ASSERT_EQ("s", deserialized.sensor);
+    ASSERT_EQ(0.0, deserialized.value);
+}
+
+TEST(JsonSerializer, ConstructedTypesThrowForMissingProperties)
+{
+    JsonSerializer serializer{};
+    JsonSerializer requiredSerializer{JsonSerializerSettings{ .propertiesRequired = true }};
+
+    ASSERT_THROW(serializer.Deserialize<Snapshot>("{\"id\":1}"), OpCoSerializerException);
+    ASSERT_THROW(requiredSerializer.Deserialize<Reading>("{\"sensor\":\"s\"}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, ConstructedTypesAreReleasedAfterFailure)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<Snapshot>("{\"id\":1,\"latest\":{\"sensor\":\"s\",\"value\":"), OpCoSerializerException);
+    ASSERT_EQ("t", serializer.Deserialize<Reading>("{\"sensor\":\"t\",\"value\":1}").sensor);
+}
+
+struct Particle final
+{
+    double x = 0.0;
+    int y = 0;
+    std::string label;
+
+    bool operator==(Particle const& other) const = default;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Particle::x, "x"),
+            MakeProperty(&Particle::y, "y"),
+            MakeProperty(&Particle::label, "label")
+        );
+    };
+};
+
+struct Cloud final
+{
+    int id = 0;
+    Columnar<Particle> particles;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Cloud::id, "id"),
+            MakeProperty(&Cloud::particles, "particles")
+        );
+    };
+};
+
+TEST(JsonSerializer, ColumnarWritesColumnPerProperty)
+{
+    JsonSerializer serializer{};
+    Cloud value{ 3, std::vector<Particle>{ Particle { 1.5, 2, "a" }, Particle { -1, 4, "b" } } };
+    std::string expected{"{\"id\":3,\"particles\":{\"x\":[1.5,-1.0],\"y\":[2,4],\"label\":[\"a\",\"b\"]}}"};
+    rapidjson::Document document;
+
+    auto serialized = serializer.Serialize(value);
+    auto deserialized = serializer.Deserialize<Cloud>(serialized);
+    document.Parse(serialized.c_str());
+
+    ASSERT_EQ(expected, serialized);
+    ASSERT_EQ(value.particles, deserialized.particles);
+    ASSERT_EQ(value.particles, JsonTypeSerializer<Columnar<Particle>>::Deserialize(document["particles"]));
+}
+
+TEST(JsonSerializer, ColumnarDeserializeIntoReusesElements)
+{
+    JsonSerializer serializer{};
+    Columnar<Particle> value{ Particle { 1, 1, "a label which does not fit in a small string" }, Particle {}, Particle {} };
+    auto label = value[0].label.data();
+
+    serializer.DeserializeInto("{\"y\":[7],\"unknown\":[1,2],\"x\":[0.5],\"label\":[\"a label which still fits\"]}", value);
+
+    ASSERT_EQ((Columnar<Particle>{ Particle { 0.5, 7, "a label which still fits" } }), value);
+    ASSERT_EQ(label, value[0].label.data());
+}
+
+TEST(JsonSerializer, ColumnarThrowsForColumnsOfDifferentLengths)
+{
+    JsonSerializer serializer{};
+    rapidjson::Document document;
+    document.Parse("{\"x\":[1,2],\"y\":[1],\"label\":[\"a\",\"b\"]}");
+
+    ASSERT_THROW(serializer.Deserialize<Columnar<Particle>>("{\"x\":[1,2],\"y\":[1],\"label\":[\"a\",\"b\"]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Columnar<Particle>>("{\"x\":[1],\"y\":[1,2],\"label\":[\"a\"]}"), OpCoSerializerException);
+    ASSERT_THROW(JsonTypeSerializer<Columnar<Particle>>::Deserialize(document), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, ColumnarThrowsForMissingNestedColumn)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<Cloud>("{\"id\":1,\"particles\":{\"x\":[],\"y\":[]}}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, DeltaWritesOnlyChanges)
+{
+    JsonSerializer serializer{};
+    WithNestedVector previous = { { Nested { 1 }, Nested { 2 }, Nested { 3 } }, { "a", "b" }, {}, TestEnum::Value };
+    auto current = previous;
+    current.nested[1].value = 5;
+    current.nested.push_back(Nested { 7 });
+    current.strings.pop_back();
+
+    auto delta = serializer.SerializeDelta(previous, current);
+
+    ASSERT_EQ("{\"nested\":{\"size\":4,\"changes\":[[1,{\"value\":5}],[3,{\"value\":7}]]},\"strings\":{\"size\":1,\"changes\":[]}}", delta);
+    ASSERT_EQ("{}", serializer.SerializeDelta(current, current));
+}
+
+struct Sample final
+{
+    double t = 0.0;
+    int n = 0;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Sample::t, "t"),
+            MakeProperty(&Sample::n, "n")
+        );
+    };
+};
+
+struct Trace final
+{
+    int id = 0;
+    Columnar<Sample> samples;
+
+    static auto constexpr SerializerProperties() { 
+        return std::make_tuple(
+            MakeProperty(&Trace::id, "id"),
+            MakeProperty(&Trace::samples, "samples")
+        );
+    };
+};
+
+TEST(JsonSerializer, DeltaComparesColumnarElementwise)
+{
+    JsonSerializer serializer{};
+    Trace previous{ 1, std::vector<Sample>{ Sample { 0.5, 1 }, Sample { 1.5, 2 } } };
+    auto current = previous;
+    current.samples[1].n = 3;
+
+    ASSERT_EQ("{}", serializer.SerializeDelta(previous, previous));
+    ASSERT_EQ("{\"samples\":{\"t\":[0.5,1.5],\"n\":[1,3]}}", serializer.SerializeDelta(previous, current));
+}
+
+TEST(JsonSerializer, DeltaComparesFloatingPointBits)
+{
+    JsonSerializer serializer{};
+    Sample previous{ 0.0, 1 };
+    auto current = previous;
+    current.t = -0.0;
+    Sample nan{ std::numeric_limits<double>::quiet_NaN(), 1 };
+
+    ASSERT_EQ("{\"t\":-0.0}", serializer.SerializeDelta(previous, current));
+    ASSERT_EQ("{}", serializer.SerializeDelta(nan, nan));
+}
+
+TEST(JsonSerializer, ApplyDeltaPatchesInPlace)
+{
+    JsonSerializer serializer{};
+    TestTypeWithProperties previous;
+    previous.s = "a string which does not fit in a small string";
+    auto current = previous;
+    current.i = 9;
+    current.v = { 1.2, 5.6, 7.8 };
+    auto target = previous;
+    auto string = target.s.data();
+
+    serializer.ApplyDelta(serializer.SerializeDelta(previous, current), target);
+
+    ASSERT_EQ(serializer.Serialize(current), serializer.Serialize(target));
+    ASSERT_EQ(string, target.s.data());
+}
+
+TEST(JsonSerializer, ApplyDeltaThrowsForInvalidDelta)
+{
+    JsonSerializer serializer{};
+    WithNestedVector value = { { Nested { 1 } }, {}, {}, TestEnum::Value };
+
+    ASSERT_THROW(serializer.ApplyDelta("{\"nested\":[]}", value), OpCoSerializerException);
+    ASSERT_THROW(serializer.ApplyDelta("{\"nested\":{\"size\":1,\"changes\":[[3,{\"value\":1}]]}}", value), OpCoSerializerException);
+    ASSERT_THROW(serializer.ApplyDelta("{\"nested\":{\"size\":2,\"changes\":[]}}", value), OpCoSerializerException);
+    ASSERT_THROW(serializer.ApplyDelta("{\"nested\"", value), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, FixedSizeBoundIsComputedAtCompileTime)
+{
+    static_assert(JsonFixedSizeBoundV<Nested> == 21);
+    static_assert(JsonFixedSizeBoundV<std::string> == 0);
+    static_assert(JsonFixedSizeBoundV<WithNested> == 32);
+    static_assert(JsonFixedSizeBoundV<WithNestedVector> == 0);
+    JsonSerializer serializer{};
+
+    ASSERT_LE(serializer.Serialize(Nested { std::numeric_limits<int>::min() }).size(), JsonFixedSizeBoundV<Nested>);
+}
+
+TEST(JsonSerializer, SerializedSizeBoundIsUpperBound)
+{
+    JsonSerializer serializer{};
+    TestTypeWithProperties value;
+    value.s = "escaped \"\\\n\x01";
+    value.v = { -1.2345678901234567e-300, 1e300, 0.0 };
+    WithNestedVector nested = { { Nested { -1 }, Nested { 20 } }, { "a", "" }, {}, TestEnum::Value };
+    Cloud cloud{ 1, std::vector<Particle>{ Particle { 1.5, -3, "label" } } };
+
+    ASSERT_EQ(serializer.Serialize(value.s).size(), SerializedSizeBound(value.s));
+    ASSERT_LE(serializer.Serialize(value).size(), SerializedSizeBound(value));
+    ASSERT_LE(serializer.Serialize(nested).size(), SerializedSizeBound(nested));
+    ASSERT_LE(serializer.Serialize(cloud).size(), SerializedSizeBound(cloud));
+}
+
+TEST(JsonSerializer, SerializesEscapedStringsLikeRapidjson)
+{
+    JsonSerializer serializer{};
+    std::string value = "plain \"quoted\" back\\slash \xC3\xA9 ";
+    for (auto c = 0; c < 0x20; ++c)
+    {
+        value += static_cast<char>(c);
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(std::string(buffer.GetString(), buffer.GetSize()), serialized);
+    ASSERT_EQ(serialized.size(), SerializedSizeBound(value));
+    ASSERT_EQ(value, serializer.Deserialize<std::string>(serialized));
+}
+
+TEST(JsonSerializer, DoublesReadTheSameFromMemoryAndStreams)
+{
+    JsonSerializer serializer{};
+    std::string json = "{\"double\":1.3927926388013963e-143,\"vector\":[1.3927926388013963e-143,9.5998012756364456e-283]}";
+    std::istringstream stream(json);
+
+    auto fromString = serializer.Deserialize<TestTypeWithProperties>(std::string_view(json));
+    auto fromStream = serializer.Deserialize<TestTypeWithProperties>(stream);
+
+    ASSERT_EQ(std::strtod("1.3927926388013963e-143", nullptr), fromString.d);
+    ASSERT_EQ(fromString.d, fromString.v[0]);
+    ASSERT_EQ(fromString.d, fromStream.d);
+    ASSERT_EQ(fromString.v, fromStream.v);
+}
+
+TEST(JsonSerializer, SerializeIntoStringTrimsOutput)
+{
+    JsonSerializer serializer{};
+    std::string serialized(1000, 'x');
+
+    serializer.Serialize(Nested { 1 }, serialized);
+
+    ASSERT_EQ("{\"value\":1}", serialized);
+}
+
+TEST(JsonSerializer, SerializeIntoLargeStringOnlySizesBound)
+{
+    JsonSerializer serializer{};
+    std::string serialized;
+    serialized.reserve(std::size_t{ 1 } << 28);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < 50; ++i)
+    {
+        serializer.Serialize(Nested { i }, serialized);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ("{\"value\":49}", serialized);
+    ASSERT_GE(serialized.capacity(), std::size_t{ 1 } << 28);
+    ASSERT_LT(elapsed, std::chrono::milliseconds(250));
+}
+
+struct SensorReading final
+{
+    double value;
+    double raw;
+
+    static auto constexpr SerializerProperties() {
+        return std::make_tuple(
+            MakeProperty(&SensorReading::value, "value"),
+            WithNumberFormat(MakeProperty(&SensorReading::raw, "raw"), JsonNumberFormat::HexFloat)
+        );
+    };
+};
+
+TEST(JsonSerializer, NumberFormatsWriteDoubles)
+{
+    auto serialize = [](JsonNumberFormat numberFormat, double value) {
+        JsonSerializer serializer{JsonSerializerSettings{ .numberFormat = numberFormat, .maxDecimalPlaces = 2 }};
+        return serializer.Serialize(Vector2 { value, -value });
+    };
+
+    ASSERT_EQ("{\"x\":0.3333333333333333,\"y\":-0.3333333333333333}", serialize(JsonNumberFormat::Shortest, 1.0 / 3));
+    ASSERT_EQ("{\"x\":0.33,\"y\":-0.33}", serialize(JsonNumberFormat::Fixed, 1.0 / 3));
+    ASSERT_EQ("{\"x\":0.33333334,\"y\":-0.33333334}", serialize(JsonNumberFormat::Float32, 1.0 / 3));
+    ASSERT_EQ("{\"x\":\"0x1.8p+1\",\"y\":\"-0x1.8p+1\"}", serialize(JsonNumberFormat::HexFloat, 3.0));
+}
+
+TEST(JsonSerializer, HexFloatRoundTripsExactly)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .numberFormat = JsonNumberFormat::HexFloat }};
+    TestTypeWithProperties value = { 1, 0.1 + 0.2, true, { -0.0, 5e-324, 1.7976931348623157e308 }, "hex" };
+
+    auto deserialized = serializer.Deserialize<TestTypeWithProperties>(serializer.Serialize(value));
+
+    ASSERT_EQ(value, deserialized);
+    ASSERT_TRUE(std::signbit(deserialized.v[0]));
+}
+
+TEST(JsonSerializer, HexFloatThrowsForOtherStrings)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"1.5\",\"y\":0}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"0x-1p0\",\"y\":0}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"0x1p0z\",\"y\":0}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"0xinf\",\"y\":0}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"-0xnan\",\"y\":0}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Vector2>("{\"x\":\"0xnan\",\"y\":0}"), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, NumberFormatOfPropertyOverridesSettings)
+{
+    JsonSerializer serializer{JsonSerializerSettings{ .numberFormat = JsonNumberFormat::Float32 }};
+    SensorReading reading = { 0.1, 0.1 };
+
+    auto serialized = serializer.Serialize(reading);
+    auto deserialized = serializer.Deserialize<SensorReading>(serialized);
+
+    ASSERT_EQ("{\"value\":0.1,\"raw\":\"0x1.999999999999ap-4\"}", serialized);
+    ASSERT_EQ(0.1, deserialized.raw);
+    ASSERT_EQ(0.1, deserialized.value);
+}
+
+struct NumericVectors final
+{
+    std::vector<double> d;
+    std::vector<float> f;
+    std::vector<int> i;
+    std::vector<uint64_t> u;
+    std::vector<int8_t> small;
+
+    bool operator==(NumericVectors const& other) const = default;
+
+    static auto constexpr SerializerProperties() {
+        return std::make_tuple(
+            MakeProperty(&NumericVectors::d, "d"),
+            MakeProperty(&NumericVectors::f, "f"),
+            MakeProperty(&NumericVectors::i, "i"),
+            MakeProperty(&NumericVectors::u, "u"),
+            MakeProperty(&NumericVectors::small, "small")
+        );
+    };
+};
+
+TEST(JsonSerializer, NumericVectorsMatchElementWise)
+{
+    JsonSerializer serializer{};
+    NumericVectors value = { {}, { 0.1f, -3.5f }, {}, { 0, UINT64_MAX }, { -128, 127 } };
+    for (int n = 0; n < 2000; ++n)
+    {
+        value.d.push_back(n % 2 == 0 ? n / 7.0 : -n * 1e295);
+        value.i.push_back(n % 2 == 0 ? INT_MIN + n : INT_MAX - n);
+    }
+
+    value.d.insert(value.d.end(), { -0.0, 5e-324, 1.7976931348623157e308 });
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_EQ(SerializeThroughDocument<rapidjson::Writer<rapidjson::StringBuffer>>(value), serialized);
+    ASSERT_EQ(value, serializer.Deserialize<NumericVectors>(serialized));
+}
+
+TEST(JsonSerializer, NumericVectorsThrowForNonFiniteValues)
+{
+    JsonSerializer serializer{};
+    NumericVectors value = { { 1.0, std::numeric_limits<double>::infinity() }, {}, {}, {}, {} };
+
+    ASSERT_THROW(serializer.Serialize(value), OpCoSerializerException);
+}
+
+TEST(JsonSerializer, NumericVectorsReadAnyValidJson)
+{
+    JsonSerializer serializer{};
+    NumericVectors value = { { 9, 9, 9, 9, 9 }, {}, { 9 }, {}, {} };
+
+    serializer.DeserializeInto("{\"d\": [ 1 ,\n2.5E3,-0, \"0x1p+1\" ,4], \"i\":[ ], \"u\":[18446744073709551615]}", value);
+
+    ASSERT_EQ((std::vector<double>{ 1, 2500, 0, 2, 4 }), value.d);
+    ASSERT_TRUE(std::signbit(value.d[2]));
+    ASSERT_TRUE(value.i.empty());
+    ASSERT_EQ((std::vector<uint64_t>{ UINT64_MAX }), value.u);
+}
+
+TEST(JsonSerializer, NumericVectorsThrowForInvalidJson)
+{
+    JsonSerializer serializer{};
+
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[1,2,]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[1,]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[1 2]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[01]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[1.]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"d\":[1"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"i\":[1,2.5]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"u\":[1,-1]}"), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<NumericVectors>("{\"small\":[128]}"), OpCoSerializerException);
+}
@@ -0,0 +1,310 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <limits>
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::MsgPack;
+
+namespace
+{
+    enum class Color : int8_t
+    {
+        Blue = -1,
+        Red,
+        Green
+    };
+
+    struct Numbers final
+    {
+        int8_t int8 = 0;
+        int16_t int16 = 0;
+        int32_t int32 = 0;
+        int64_t int64 = 0;
+        uint8_t uint8 = 0;
+        uint16_t uint16 = 0;
+        uint32_t uint32 = 0;
+        uint64_t uint64 = 0;
+        float single = 0.0f;
+        double real = 0.0;
+        bool flag = false;
+        Color color = Color::Red;
+
+        bool operator==(Numbers const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Numbers::int8, "int8"),
+                MakeProperty(&Numbers::int16, "int16"),
+                MakeProperty(&Numbers::int32, "int32"),
+                MakeProperty(&Numbers::int64, "int64"),
+                MakeProperty(&Numbers::uint8, "uint8"),
+                MakeProperty(&Numbers::uint16, "uint16"),
+                MakeProperty(&Numbers::uint32, "uint32"),
+                MakeProperty(&Numbers::uint64, "uint64"),
+                MakeProperty(&Numbers::single, "single"),
+                MakeProperty(&Numbers::real, "real"),
+                MakeProperty(&Numbers::flag, "flag"),
+                MakeProperty(&Numbers::color, "color")
+            );
+        };
+    };
+
+    struct Document final
+    {
+        std::string name;
+        std::vector<Numbers> numbers;
+        std::vector<std::string> tags;
+        std::vector<bool> bits;
+        std::vector<std::vector<int>> nested;
+
+        bool operator==(Document const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Document::name, "name"),
+                MakeProperty(&Document::numbers, "numbers"),
+                MakeProperty(&Document::tags, "tags"),
+                MakeProperty(&Document::bits, "bits"),
+                MakeProperty(&Document::nested, "nested")
+            );
+        };
+    };
+
+    struct Pair final
+    {
+        int first = 0;
+        std::string second;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Pair::first, "first"),
+                MakeProperty(&Pair::second, "second")
+            );
+        };
+    };
+
+    struct Constructed final
+    {
+        Constructed(std::string label, int count)
+            : label(std::move(label)),
+              count(count)
+        {
+        }
+
+        std::string label;
+        int count;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Constructed::label, "label"),
+                MakeProperty(&Constructed::count, "count")
+            );
+        };
+    };
+
+    struct WithConstructed final
+    {
+        Constructed const first;
+        std::vector<Constructed> rest;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WithConstructed::first, "first"),
+                MakeProperty(&WithConstructed::rest, "rest")
+            );
+        };
+    };
+
+    struct WithView final
+    {
+        std::string_view view;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(MakeProperty(&WithView::view, "view"));
+        };
+    };
+
+    Document MakeDocument()
+    {
+        using Int64Limits = std::numeric_limits<int64_t>;
+        return Document {
+            "document",
+            {
+                Numbers { -100, -30000, -2000000000, Int64Limits::min(), 200, 60000, 4000000000u, std::numeric_limits<uint64_t>::max(), 0.1f, 0.1, true, Color::Blue },
+                Numbers { 1, 1000, 100000, Int64Limits::max(), 0, 0, 0, 0, -1.5f, 1e300, false, Color::Green },
+                Numbers {}
+            },
+            { "a", "", std::string(40, 'x'), std::string(300, 'y'), std::string(70000, 'z') },
+            { true, false, true },
+            { { 1, -2 }, {}, std::vector<int>(20, 7) }
+        };
+    }
+}
+
+TEST(MsgPackSerializer, WritesMapsKeyedByPropertyName)
+{
+    MsgPackSerializer serializer;
+
+    auto serialized = serializer.Serialize(Pair { 1, "a" });
+
+    ASSERT_EQ(std::string("\x82\xA5" "first" "\x01\xA6" "second" "\xA1" "a"), serialized);
+}
+
+TEST(MsgPackSerializer, WritesSmallestIntegerFormat)
+{
+    MsgPackSerializer serializer;
+
+    ASSERT_EQ(std::string("\x7F"), serializer.Serialize(int64_t{127}));
+    ASSERT_EQ(std::string("\xCC\x80"), serializer.Serialize(int64_t{128}));
+    ASSERT_EQ(std::string("\xCD\x01\x00", 3), serializer.Serialize(256));
+    ASSERT_EQ(std::string("\xCE\x00\x01\x00\x00", 5), serializer.Serialize(65536u));
+    ASSERT_EQ(std::string("\xCF\x00\x00\x00\x01\x00\x00\x00\x00", 9), serializer.Serialize(uint64_t{1} << 32));
+    ASSERT_EQ(std::string("\xE0"), serializer.Serialize(-32));
+    ASSERT_EQ(std::string("\xD0\xDF"), serializer.Serialize(-33));
+    ASSERT_EQ(std::string("\xD1\xFF\x7F"), serializer.Serialize(-129));
+    ASSERT_EQ(std::string("\xD2\xFF\xFF\x7F\xFF"), serializer.Serialize(-32769));
+    ASSERT_EQ(std::string("\xD3\x80\x00\x00\x00\x00\x00\x00\x00", 9), serializer.Serialize(std::numeric_limits<int64_t>::min()));
+}
+
+TEST(MsgPackSerializer, WritesSmallestExactFloatFormat)
+{
+    MsgPackSerializer serializer;
+
+    ASSERT_EQ(std::string("\xCA\x3F\xC0\x00\x00", 5), serializer.Serialize(1.5));
+    ASSERT_EQ(std::string("\xCA\x3F\xC0\x00\x00", 5), serializer.Serialize(1.5f));
+    ASSERT_EQ(std::string("\xCB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 9), serializer.Serialize(0.1));
+    ASSERT_EQ(std::string("\xC3"), serializer.Serialize(true));
+}
+
+TEST(MsgPackSerializer, WritesSmallestStringFormat)
+{
+    MsgPackSerializer serializer;
+
+    ASSERT_EQ(std::string("\xBF") + std::string(31, 'x'), serializer.Serialize(std::string(31, 'x')));
+    ASSERT_EQ(std::string("\xD9\x20") + std::string(32, 'x'), serializer.Serialize(std::string(32, 'x')));
+    ASSERT_EQ(std::string("\xDA\x01\x00", 3) + std::string(256, 'x'), serializer.Serialize(std::string(256, 'x')));
+    ASSERT_EQ(std::string("\xDB\x00\x01\x00\x00", 5) + std::string(65536, 'x'), serializer.Serialize(std::string(65536, 'x')));
+    ASSERT_EQ(std::string("\xDC\x00\x10", 3) + std::string(16, '\0'), serializer.Serialize(std::vector<int>(16)));
+}
+
+TEST(MsgPackSerializer, RoundTripTest)
+{
+    MsgPackSerializer serializer;
+    auto value = MakeDocument();
+
+    auto deserialized = serializer.Deserialize<Document>(serializer.Serialize(value));
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(MsgPackSerializer, DeserializeIntoReusesStorage)
+{
+    MsgPackSerializer serializer;
+    auto value = MakeDocument();
+    Document target;
+    target.numbers.resize(5);
+    target.tags.reserve(8);
+    auto tags = target.tags.data();
+
+    serializer.DeserializeInto(serializer.Serialize(value), target);
+
+    ASSERT_EQ(value, target);
+    ASSERT_EQ(tags, target.tags.data());
+}
+
+TEST(MsgPackSerializer, ReadsKeysInAnyOrderAndSkipsUnknownKeys)
+{
+    MsgPackSerializer serializer;
+    // {"unknown": [1, {"a": nil}, 2.5, "x"], "second": "b", "first": 300}
+    std::string serialized("\x83\xA7unknown\x94\x01\x81\xA1" "a\xC0\xCB\x40\x04\x00\x00\x00\x00\x00\x00\xA1x\xA6second\xA1" "b\xA5" "first\xCD\x01\x2C", 44);
+
+    auto deserialized = serializer.Deserialize<Pair>(serialized);
+
+    ASSERT_EQ(300, deserialized.first);
+    ASSERT_EQ("b", deserialized.second);
+}
+
+TEST(MsgPackSerializer, MissingPropertiesAreOptionalUnlessRequired)
+{
+    std::string serialized("\x81\xA5" "first\x05");
+
+    ASSERT_EQ(5, MsgPackSerializer().Deserialize<Pair>(serialized).first);
+    ASSERT_THROW(
+        MsgPackSerializer(MsgPackSerializerSettings{ .propertiesRequired = true }).Deserialize<Pair>(serialized),
+        OpCoSerializerException);
+}
+
+TEST(MsgPackSerializer, ConstructsTypesWithoutDefaultConstructor)
+{
+    MsgPackSerializer serializer;
+    WithConstructed value { Constructed("a", 1), { Constructed("b", 2), Constructed("c", 3) } };
+
+    auto deserialized = serializer.Deserialize<WithConstructed>(serializer.Serialize(value));
+
+    ASSERT_EQ("a", deserialized.first.label);
+    ASSERT_EQ(2u, deserialized.rest.size());
+    ASSERT_EQ(3, deserialized.rest[1].count);
+}
+
+TEST(MsgPackSerializer, StringViewsReferToBuffer)
+{
+    MsgPackSerializer serializer;
+    auto serialized = serializer.Serialize(WithView { "view" });
+
+    auto deserialized = serializer.Deserialize<WithView>(serialized);
+
+    ASSERT_EQ("view", deserialized.view);
+    ASSERT_EQ(serialized.data() + 7, deserialized.view.data());
+}
+
+TEST(MsgPackSerializer, ThrowsForOutOfRangeOrMismatchedValues)
+{
+    MsgPackSerializer serializer;
+
+    ASSERT_THROW(serializer.Deserialize<uint8_t>(serializer.Serialize(256)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<uint32_t>(serializer.Serialize(-1)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<int>(serializer.Serialize(1.5)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<std::string>(serializer.Serialize(1)), OpCoSerializerException);
+    ASSERT_EQ(3.0, serializer.Deserialize<double>(serializer.Serialize(3)));
+}
+
+TEST(MsgPackSerializer, ThrowsForTruncatedData)
+{
+    MsgPackSerializer serializer;
+    auto value = MakeDocument();
+    value.tags.pop_back();
+    auto serialized = serializer.Serialize(value);
+
+    for (std::size_t size = 0; size < serialized.size(); ++size)
+    {
+        ASSERT_THROW(serializer.Deserialize<Document>(std::string_view(serialized.data(), size)), OpCoSerializerException);
+    }
+}
+
+TEST(MsgPackSerializer, ThrowsForTrailingData)
+{
+    MsgPackSerializer serializer;
+    auto serialized = serializer.Serialize(MakeDocument()) + "x";
+
+    ASSERT_THROW(serializer.Deserialize<Document>(serialized), OpCoSerializerException);
+}
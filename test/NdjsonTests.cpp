@@ -0,0 +1,279 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Json;
+
+namespace
+{
+    struct Event final
+    {
+        int id = 0;
+        std::string name;
+        std::vector<double> values;
+
+        bool operator==(Event const& other) const
+        {
+            return id == other.id && name == other.name && values == other.values;
+        }
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Event::id, "id"),
+                MakeProperty(&Event::name, "name"),
+                MakeProperty(&Event::values, "values")
+            );
+        };
+    };
+
+    std::vector<Event> MakeEvents(int count)
+    {
+        std::vector<Event> events;
+        for (auto i = 0; i < count; ++i)
+        {
+            events.push_back(Event { i, "event " + std::to_string(i), { i * 0.5, i * 1.5 } });
+        }
+
+        return events;
+    }
+}
+
+TEST(Ndjson, WritesOneRecordPerLine)
+{
+    NdjsonWriter<Event> writer;
+
+    writer.Write(Event { 1, "a", { 1.5 } });
+    writer.Write(Event { 2, "b", {} });
+
+    ASSERT_EQ("{\"id\":1,\"name\":\"a\",\"values\":[1.5]}\n{\"id\":2,\"name\":\"b\",\"values\":[]}\n", writer.View());
+    ASSERT_EQ(2u, writer.Count());
+}
+
+TEST(Ndjson, FailedRecordIsNotWritten)
+{
+    NdjsonWriter<Event> writer;
+
+    writer.Write(Event { 1, "a", { 1.5 } });
+    ASSERT_THROW(writer.Write(Event { 2, "b", { 0.5, std::numeric_limits<double>::quiet_NaN() } }), OpCoSerializerException);
+    writer.Write(Event { 3, "c", { 2.5 } });
+
+    std::vector<Event> read;
+    NdjsonReader<Event> reader(writer.View());
+    for (auto const& event : reader)
+    {
+        read.push_back(event);
+    }
+
+    ASSERT_EQ((std::vector<Event>{ Event { 1, "a", { 1.5 } }, Event { 3, "c", { 2.5 } } }), read);
+    ASSERT_EQ(2u, writer.Count());
+}
+
+TEST(Ndjson, RoundTripTest)
+{
+    auto events = MakeEvents(10);
+    NdjsonWriter<Event> writer;
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+
+    std::vector<Event> read;
+    NdjsonReader<Event> reader(writer.View());
+    for (auto const& event : reader)
+    {
+        read.push_back(event);
+    }
+
+    ASSERT_EQ(events, read);
+    ASSERT_EQ(events.size(), reader.Count());
+}
+
+TEST(Ndjson, IteratorResetsMissingMembers)
+{
+    NdjsonReader<Event> reader("{\"id\":1,\"name\":\"a\"}\n{\"id\":2}\n");
+    std::vector<Event> read(reader.begin(), reader.end());
+
+    ASSERT_EQ(2u, read.size());
+    ASSERT_EQ("", read[1].name);
+}
+
+TEST(Ndjson, NextReusesRecord)
+{
+    NdjsonReader<Event> reader("{\"id\":1,\"name\":\"a\"}\r\n\n  {\"id\":2}");
+    Event record;
+
+    ASSERT_TRUE(reader.Next(record));
+    ASSERT_TRUE(reader.Next(record));
+    ASSERT_FALSE(reader.Next(record));
+    ASSERT_EQ(2, record.id);
+    ASSERT_EQ("a", record.name);
+}
+
+TEST(Ndjson, EmptyInputHasNoRecords)
+{
+    NdjsonReader<Event> reader(" \n");
+
+    ASSERT_EQ(reader.end(), reader.begin());
+}
+
+TEST(Ndjson, FileRoundTripTestLargerThanBuffer)
+{
+    auto events = MakeEvents(5000);
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::tmpfile(), &std::fclose);
+    {
+        NdjsonWriter<Event> writer(file.get());
+        for (auto const& event : events)
+        {
+            writer.Write(event);
+        }
+    }
+
+    std::rewind(file.get());
+    NdjsonReader<Event> reader(file.get());
+    std::vector<Event> read(reader.begin(), reader.end());
+
+    ASSERT_GT(std::ftell(file.get()), static_cast<long>(JsonStreamBufferSize));
+    ASSERT_EQ(events, read);
+}
+
+TEST(Ndjson, StreamRoundTripTest)
+{
+    auto events = MakeEvents(100);
+    std::stringstream stream;
+    NdjsonWriter<Event> writer(stream);
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+
+    writer.Flush();
+    NdjsonReader<Event> reader(stream);
+    std::vector<Event> read(reader.begin(), reader.end());
+
+    ASSERT_EQ(events, read);
+}
+
+TEST(Ndjson, ThrowsForInvalidRecord)
+{
+    NdjsonReader<Event> reader("{\"id\":1}\n{\"id\":}\n");
+    Event record;
+
+    ASSERT_TRUE(reader.Next(record));
+    ASSERT_THROW(reader.Next(record), OpCoSerializerException);
+}
+
+TEST(Ndjson, ThrowsForMissingRequiredProperty)
+{
+    NdjsonReader<Event> reader("{\"id\":1}\n", JsonSerializerSettings{ .propertiesRequired = true });
+    Event record;
+
+    ASSERT_THROW(reader.Next(record), OpCoSerializerException);
+}
+
+TEST(Ndjson, SplitsAtLineBoundaries)
+{
+    std::string input = "{\"id\":1}\n{\"id\":22}\n{\"id\":333}\n{\"id\":4444}";
+
+    for (std::size_t chunkCount = 1; chunkCount < 8; ++chunkCount)
+    {
+        auto chunks = SplitNdjson(input, chunkCount);
+
+        std::string joined;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            ASSERT_FALSE(chunks[i].empty());
+            ASSERT_TRUE(i == chunks.size() - 1 || chunks[i].back() == '\n');
+            joined += chunks[i];
+        }
+
+        ASSERT_LE(chunks.size(), chunkCount);
+        ASSERT_EQ(input, joined);
+    }
+}
+
+TEST(Ndjson, ParallelReadMatchesSequentialRead)
+{
+    auto events = MakeEvents(20000);
+    NdjsonWriter<Event> writer;
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+
+    auto read = ReadNdjsonParallel<Event>(writer.View(), 4);
+
+    ASSERT_EQ(events, read);
+}
+
+TEST(Ndjson, ParallelReadPassesEveryChunkToCallback)
+{
+    auto events = MakeEvents(20000);
+    NdjsonWriter<Event> writer;
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+
+    std::mutex mutex;
+    std::vector<std::size_t> indices;
+    std::size_t count = 0;
+    ReadNdjsonParallel<Event>(writer.View(), [&](std::size_t index, std::vector<Event>&& records)
+    {
+        std::scoped_lock lock(mutex);
+        indices.push_back(index);
+        count += records.size();
+    }, 3);
+
+    std::sort(indices.begin(), indices.end());
+    ASSERT_GT(indices.size(), 1u);
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        ASSERT_EQ(i, indices[i]);
+    }
+
+    ASSERT_EQ(events.size(), count);
+}
+
+TEST(Ndjson, ParallelReadOfEmptyInputHasNoRecords)
+{
+    ASSERT_TRUE(ReadNdjsonParallel<Event>("", 4).empty());
+}
+
+TEST(Ndjson, ParallelReadThrowsForInvalidRecord)
+{
+    NdjsonWriter<Event> writer;
+    for (auto const& event : MakeEvents(20000))
+    {
+        writer.Write(event);
+    }
+
+    std::string input(writer.View());
+    input += "{\"id\":}\n";
+
+    ASSERT_THROW(ReadNdjsonParallel<Event>(input, 4), OpCoSerializerException);
+}
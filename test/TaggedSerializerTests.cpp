@@ -0,0 +1,296 @@
+// Copyright (c) 2022 OpCoSim
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include "OpCoSerializer/OpCoSerializer.hpp"
+
+using namespace OpCoSerializer;
+using namespace OpCoSerializer::Tagged;
+
+namespace
+{
+    enum class Status : int8_t
+    {
+        Failed = -1,
+        Unknown,
+        Ready
+    };
+
+    struct Simple final
+    {
+        uint32_t number = 0;
+        std::string text;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Simple::number, "number"),
+                MakeProperty(&Simple::text, "text")
+            );
+        };
+    };
+
+    struct Reading final
+    {
+        int32_t value = 0;
+        Status status = Status::Unknown;
+
+        bool operator==(Reading const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Reading::value, "value", 1),
+                MakeProperty(&Reading::status, "status", 7)
+            );
+        };
+    };
+
+    // The first version of a nested message, before status was added.
+    struct ReadingVersion1 final
+    {
+        int32_t value = 0;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&ReadingVersion1::value, "value", 1)
+            );
+        };
+    };
+
+    // The first version of a message.
+    struct UnitVersion1 final
+    {
+        int id = 0;
+        std::string name;
+        std::vector<ReadingVersion1> readings;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&UnitVersion1::id, "id", 1),
+                MakeProperty(&UnitVersion1::name, "name", 2),
+                MakeProperty(&UnitVersion1::readings, "readings", 3)
+            );
+        };
+    };
+
+    // A later version of the same message, with fields added in between.
+    struct Unit final
+    {
+        int id = 0;
+        std::vector<Reading> readings;
+        std::string name;
+        double speed = 0.0;
+        std::vector<double> track;
+        std::vector<int64_t> counters;
+        std::vector<bool> flags;
+        std::vector<std::string> tags;
+        std::vector<std::vector<int>> nested;
+        bool active = false;
+        uint64_t large = 0;
+
+        bool operator==(Unit const& other) const = default;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Unit::id, "id", 1),
+                MakeProperty(&Unit::readings, "readings", 3),
+                MakeProperty(&Unit::name, "name", 2),
+                MakeProperty(&Unit::speed, "speed", 4),
+                MakeProperty(&Unit::track, "track", 5),
+                MakeProperty(&Unit::counters, "counters", 6),
+                MakeProperty(&Unit::flags, "flags", 7),
+                MakeProperty(&Unit::tags, "tags", 8),
+                MakeProperty(&Unit::nested, "nested", 9),
+                MakeProperty(&Unit::active, "active", 10),
+                MakeProperty(&Unit::large, "large", 1000)
+            );
+        };
+    };
+
+    struct Constructed final
+    {
+        Constructed(std::string label, std::vector<int> values)
+            : label(std::move(label)),
+              values(std::move(values))
+        {
+        }
+
+        std::string label;
+        std::vector<int> values;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&Constructed::label, "label"),
+                MakeProperty(&Constructed::values, "values")
+            );
+        };
+    };
+
+    struct WithConstructed final
+    {
+        Constructed const first;
+        std::vector<Constructed> rest;
+
+        static auto constexpr SerializerProperties() { 
+            return std::make_tuple(
+                MakeProperty(&WithConstructed::first, "first"),
+                MakeProperty(&WithConstructed::rest, "rest")
+            );
+        };
+    };
+
+    Unit MakeUnit()
+    {
+        return Unit {
+            -7,
+            { Reading { 3, Status::Ready }, Reading { -300, Status::Failed } },
+            std::string(200, 'n'),
+            12.5,
+            { 1.5, -2.5, 3.25 },
+            { -1, 0, std::numeric_limits<int64_t>::min() },
+            { true, false },
+            { "a", "" },
+            { { 1, 2 }, {}, { -3 } },
+            true,
+            std::numeric_limits<uint64_t>::max()
+        };
+    }
+}
+
+TEST(TaggedSerializer, WritesProtocolBuffersWireFormat)
+{
+    TaggedSerializer serializer;
+
+    ASSERT_EQ(std::string("\x08\x96\x01\x12\x07testing"), serializer.Serialize(Simple { 150, "testing" }));
+}
+
+TEST(TaggedSerializer, ZigZagEncodesSignedIntegersAndEnums)
+{
+    TaggedSerializer serializer;
+
+    ASSERT_EQ(std::string("\x08\x01\x38\x01"), serializer.Serialize(Reading { -1, Status::Failed }));
+    ASSERT_EQ(std::string("\x08\xD7\x04\x38\x02"), serializer.Serialize(Reading { -300, Status::Ready }));
+    ASSERT_EQ(0u, ZigZagEncode(0));
+    ASSERT_EQ(3u, ZigZagEncode(-2));
+    ASSERT_EQ(std::numeric_limits<int64_t>::min(), ZigZagDecode(ZigZagEncode(std::numeric_limits<int64_t>::min())));
+}
+
+TEST(TaggedSerializer, PacksRepeatedNumbers)
+{
+    TaggedSerializer serializer;
+    Unit value;
+    value.counters = { 1, 2, 3 };
+    value.track = { 1.0 };
+
+    auto serialized = serializer.Serialize(value);
+
+    ASSERT_NE(std::string::npos, serialized.find(std::string("\x32\x03\x02\x04\x06")));
+    ASSERT_NE(std::string::npos, serialized.find(std::string("\x2A\x08\x00\x00\x00\x00\x00\x00\xF0\x3F", 10)));
+}
+
+TEST(TaggedSerializer, RoundTripTest)
+{
+    TaggedSerializer serializer;
+    auto value = MakeUnit();
+
+    auto deserialized = serializer.Deserialize<Unit>(serializer.Serialize(value));
+
+    ASSERT_EQ(value, deserialized);
+}
+
+TEST(TaggedSerializer, ReadsOlderAndNewerVersions)
+{
+    TaggedSerializer serializer;
+
+    auto older = serializer.Deserialize<UnitVersion1>(serializer.Serialize(MakeUnit()));
+    auto newer = serializer.Deserialize<Unit>(serializer.Serialize(UnitVersion1 { 4, "unit", { ReadingVersion1 { 5 } } }));
+
+    ASSERT_EQ(-7, older.id);
+    ASSERT_EQ(std::string(200, 'n'), older.name);
+    ASSERT_EQ(2u, older.readings.size());
+    ASSERT_EQ(-300, older.readings[1].value);
+    ASSERT_EQ(4, newer.id);
+    ASSERT_EQ("unit", newer.name);
+    ASSERT_EQ((std::vector<Reading>{ Reading { 5, Status::Unknown } }), newer.readings);
+    ASSERT_THROW(
+        TaggedSerializer(TaggedSerializerSettings{ .propertiesRequired = true }).Deserialize<Unit>(serializer.Serialize(UnitVersion1 { 4, "unit", { ReadingVersion1 { 5 } } })),
+        OpCoSerializerException);
+}
+
+TEST(TaggedSerializer, ReadsUnpackedRepeatedNumbers)
+{
+    TaggedSerializer serializer;
+
+    auto deserialized = serializer.Deserialize<Unit>(std::string("\x30\x02\x30\x04\x32\x01\x06\x29\x00\x00\x00\x00\x00\x00\xF0\x3F", 16));
+
+    ASSERT_EQ((std::vector<int64_t>{ 1, 2, 3 }), deserialized.counters);
+    ASSERT_EQ((std::vector<double>{ 1.0 }), deserialized.track);
+}
+
+TEST(TaggedSerializer, DeserializeIntoReusesStorage)
+{
+    TaggedSerializer serializer;
+    auto value = MakeUnit();
+    Unit target;
+    target.readings.resize(5);
+    target.tags.reserve(8);
+    target.counters = { 9, 9, 9, 9, 9 };
+    auto tags = target.tags.data();
+
+    serializer.DeserializeInto(serializer.Serialize(value), target);
+
+    ASSERT_EQ(value, target);
+    ASSERT_EQ(tags, target.tags.data());
+}
+
+TEST(TaggedSerializer, ConstructsTypesWithoutDefaultConstructor)
+{
+    TaggedSerializer serializer;
+    WithConstructed value { Constructed("a", { 1 }), { Constructed("b", {}), Constructed("c", { 2, 3 }) } };
+
+    auto deserialized = serializer.Deserialize<WithConstructed>(serializer.Serialize(value));
+
+    ASSERT_EQ("a", deserialized.first.label);
+    ASSERT_EQ(2u, deserialized.rest.size());
+    ASSERT_TRUE(deserialized.rest[0].values.empty());
+    ASSERT_EQ((std::vector<int>{ 2, 3 }), deserialized.rest[1].values);
+}
+
+TEST(TaggedSerializer, MissingPropertiesAreOptionalUnlessRequired)
+{
+    std::string serialized("\x08\x05");
+
+    ASSERT_EQ(5u, TaggedSerializer().Deserialize<Simple>(serialized).number);
+    ASSERT_THROW(
+        TaggedSerializer(TaggedSerializerSettings{ .propertiesRequired = true }).Deserialize<Simple>(serialized),
+        OpCoSerializerException);
+}
+
+TEST(TaggedSerializer, ThrowsForInvalidData)
+{
+    TaggedSerializer serializer;
+    auto serialized = serializer.Serialize(MakeUnit());
+
+    ASSERT_THROW(serializer.Deserialize<Unit>(serialized.substr(0, serialized.size() - 1)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Simple>(std::string("\x12\x05" "abc")), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Simple>(std::string("\x0A\x01" "a")), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Simple>(std::string("\x00\x01", 2)), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Simple>(std::string("\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01")), OpCoSerializerException);
+    ASSERT_THROW(serializer.Deserialize<Simple>(std::string("\x08\x80\x80\x80\x80\x10")), OpCoSerializerException);
+}